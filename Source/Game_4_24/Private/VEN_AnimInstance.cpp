@@ -13,6 +13,75 @@
 
 using namespace vendetta;
 
+namespace
+{
+	void apply_trigger(bool& flag, uint16 trigger, const FVEN_AnimationSnapshot& snapshot)
+	{
+		if (snapshot.raised_triggers & trigger)
+			flag = true;
+		else if (snapshot.lowered_triggers & trigger)
+			flag = false;
+	}
+}
+
+FVEN_AnimInstanceProxy::FVEN_AnimInstanceProxy()
+{
+
+}
+
+FVEN_AnimInstanceProxy::FVEN_AnimInstanceProxy(UAnimInstance* instance)
+	: FAnimInstanceProxy(instance)
+{
+
+}
+
+void FVEN_AnimInstanceProxy::PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds)
+{
+	FAnimInstanceProxy::PreUpdate(InAnimInstance, DeltaSeconds);
+
+	const auto& instance = Cast<UVEN_AnimInstance>(InAnimInstance);
+	if (!instance)
+		return;
+
+	//speed is read here, NativeUpdateAnimation runs after PreUpdate and would hand over last frame's velocity
+	if (instance->m_pending_snapshot.owned_fields & FVEN_AnimationSnapshot::SPEED)
+		instance->m_pending_snapshot.speed = instance->m_owner ? instance->m_owner->GetVelocity().Size() : 0.f;
+
+	//triggers are handed over once, the graph keeps flags raised until it consumes them
+	m_snapshot = instance->m_pending_snapshot;
+	instance->m_pending_snapshot.raised_triggers = 0;
+	instance->m_pending_snapshot.lowered_triggers = 0;
+}
+
+void FVEN_AnimInstanceProxy::Update(float DeltaSeconds)
+{
+	FAnimInstanceProxy::Update(DeltaSeconds);
+
+	const auto& instance = Cast<UVEN_AnimInstance>(GetAnimInstanceObject());
+	if (!instance)
+		return;
+
+	if (m_snapshot.owned_fields & FVEN_AnimationSnapshot::SPEED)
+		instance->Speed = m_snapshot.speed;
+	if (m_snapshot.owned_fields & FVEN_AnimationSnapshot::ANIMATION_INDEX)
+		instance->AnimationIndex = m_snapshot.animation_index;
+	if (m_snapshot.owned_fields & FVEN_AnimationSnapshot::ACTION_INDEX)
+		instance->ActionIndex = m_snapshot.action_index;
+	if (m_snapshot.owned_fields & FVEN_AnimationSnapshot::IN_BATTLE)
+		instance->InBattle = m_snapshot.in_battle;
+
+	apply_trigger(instance->PickItem, FVEN_AnimationSnapshot::PICK_ITEM, m_snapshot);
+	apply_trigger(instance->Attack_1, FVEN_AnimationSnapshot::ATTACK_1, m_snapshot);
+	apply_trigger(instance->Attack_2, FVEN_AnimationSnapshot::ATTACK_2, m_snapshot);
+	apply_trigger(instance->StunStart, FVEN_AnimationSnapshot::STUN_START, m_snapshot);
+	apply_trigger(instance->StunFinish, FVEN_AnimationSnapshot::STUN_FINISH, m_snapshot);
+	apply_trigger(instance->ReceiveDamageFront, FVEN_AnimationSnapshot::RECEIVE_DAMAGE_FRONT, m_snapshot);
+	apply_trigger(instance->ReceiveDamageBack, FVEN_AnimationSnapshot::RECEIVE_DAMAGE_BACK, m_snapshot);
+	apply_trigger(instance->ReceiveDamageLeft, FVEN_AnimationSnapshot::RECEIVE_DAMAGE_LEFT, m_snapshot);
+	apply_trigger(instance->ReceiveDamageRight, FVEN_AnimationSnapshot::RECEIVE_DAMAGE_RIGHT, m_snapshot);
+	apply_trigger(instance->Die, FVEN_AnimationSnapshot::DIE, m_snapshot);
+}
+
 UVEN_AnimInstance::UVEN_AnimInstance()
 	: AnimationIndex(-1)
 	, ActionIndex(0)
@@ -46,7 +115,13 @@ void UVEN_AnimInstance::NativeBeginPlay()
 		//debug_log("UVEN_AnimInstance::NativeBeginPlay. Owner is broken", FColor::Red);
 		return;
 	}
-		
+
+	//snapshot starts from values of the graph, owner updates go on from them
+	m_pending_snapshot.speed = Speed;
+	m_pending_snapshot.animation_index = AnimationIndex;
+	m_pending_snapshot.action_index = ActionIndex;
+	m_pending_snapshot.in_battle = InBattle;
+
 	OwningUnitRegistration();
 }
 
@@ -96,15 +171,15 @@ void UVEN_AnimInstance::OnActionFromOwner(ANIMATION_ACTION action)
 
 	switch (action)
 	{
-		case ANIMATION_ACTION::PICK_ITEM: PickItem = true; break;
-		case ANIMATION_ACTION::ATTACK_1: Attack_1 = true; break;
-		case ANIMATION_ACTION::ATTACK_2: Attack_2 = true; break;
-		case ANIMATION_ACTION::RECEIVE_DAMAGE_BACK: ReceiveDamageBack = true; break;
-		case ANIMATION_ACTION::RECEIVE_DAMAGE_FRONT: ReceiveDamageFront = true; break;
-		case ANIMATION_ACTION::RECEIVE_DAMAGE_LEFT: ReceiveDamageLeft = true; break;
-		case ANIMATION_ACTION::RECEIVE_DAMAGE_RIGHT: ReceiveDamageRight = true; break;
-		case ANIMATION_ACTION::STUN: StunStart = true; break;
-		case ANIMATION_ACTION::DIE: Die = true; break;
+		case ANIMATION_ACTION::PICK_ITEM: RaiseTrigger(FVEN_AnimationSnapshot::PICK_ITEM); break;
+		case ANIMATION_ACTION::ATTACK_1: RaiseTrigger(FVEN_AnimationSnapshot::ATTACK_1); break;
+		case ANIMATION_ACTION::ATTACK_2: RaiseTrigger(FVEN_AnimationSnapshot::ATTACK_2); break;
+		case ANIMATION_ACTION::RECEIVE_DAMAGE_BACK: RaiseTrigger(FVEN_AnimationSnapshot::RECEIVE_DAMAGE_BACK); break;
+		case ANIMATION_ACTION::RECEIVE_DAMAGE_FRONT: RaiseTrigger(FVEN_AnimationSnapshot::RECEIVE_DAMAGE_FRONT); break;
+		case ANIMATION_ACTION::RECEIVE_DAMAGE_LEFT: RaiseTrigger(FVEN_AnimationSnapshot::RECEIVE_DAMAGE_LEFT); break;
+		case ANIMATION_ACTION::RECEIVE_DAMAGE_RIGHT: RaiseTrigger(FVEN_AnimationSnapshot::RECEIVE_DAMAGE_RIGHT); break;
+		case ANIMATION_ACTION::STUN: RaiseTrigger(FVEN_AnimationSnapshot::STUN_START); break;
+		case ANIMATION_ACTION::DIE: RaiseTrigger(FVEN_AnimationSnapshot::DIE); break;
 		default: /*debug_log("UVEN_AnimInstance::OnActionFromOwner. Invalid action", FColor::Red);*/ break;
 	}
 }
@@ -115,21 +190,24 @@ void UVEN_AnimInstance::OnUpdateFromOwner(ANIMATION_UPDATE update)
 	{
 		case ANIMATION_UPDATE::START_BATTLE:
 		{
-			InBattle = true;
+			m_pending_snapshot.in_battle = true;
+			m_pending_snapshot.owned_fields |= FVEN_AnimationSnapshot::IN_BATTLE;
 			TryToStopActiveAction();
 		}break;
 		case ANIMATION_UPDATE::FINISH_BATTLE:
 		{
-			InBattle = false;
+			m_pending_snapshot.in_battle = false;
+			m_pending_snapshot.owned_fields |= FVEN_AnimationSnapshot::IN_BATTLE;
 		}break;
 		case ANIMATION_UPDATE::FINISH_STUN:
 		{
-			StunFinish = true;
+			RaiseTrigger(FVEN_AnimationSnapshot::STUN_FINISH);
 			ResetActiveAction();
 		}break;
 		case ANIMATION_UPDATE::START_NEXT_ACTION:
 		{
-			ActionIndex += 1;
+			m_pending_snapshot.action_index += 1;
+			m_pending_snapshot.owned_fields |= FVEN_AnimationSnapshot::ACTION_INDEX;
 		}break;
 		case ANIMATION_UPDATE::START_MOVEMENT:
 		{
@@ -147,6 +225,28 @@ ANIMATION_ACTION UVEN_AnimInstance::GetActiveAnimationAction() const
 	return m_active_action;
 }
 
+FAnimInstanceProxy* UVEN_AnimInstance::CreateAnimInstanceProxy()
+{
+	return new FVEN_AnimInstanceProxy(this);
+}
+
+void UVEN_AnimInstance::RaiseTrigger(uint16 trigger)
+{
+	m_pending_snapshot.raised_triggers |= trigger;
+	m_pending_snapshot.lowered_triggers &= ~trigger;
+}
+
+void UVEN_AnimInstance::LowerTrigger(uint16 trigger)
+{
+	m_pending_snapshot.lowered_triggers |= trigger;
+	m_pending_snapshot.raised_triggers &= ~trigger;
+}
+
+int UVEN_AnimInstance::GetAnimationIndex() const
+{
+	return m_pending_snapshot.animation_index;
+}
+
 void UVEN_AnimInstance::OwningUnitRegistration()
 {
 	if (!m_owner)
@@ -159,6 +259,7 @@ void UVEN_AnimInstance::OwningUnitRegistration()
 	if (owner_player_unit)
 	{
 		owner_player_unit->RegisterAnimInstance(this);
+		m_pending_snapshot.owned_fields |= FVEN_AnimationSnapshot::SPEED;
 		return;
 	}
 
@@ -166,7 +267,8 @@ void UVEN_AnimInstance::OwningUnitRegistration()
 	if (owner_enemy_unit)
 	{
 		owner_enemy_unit->RegisterAnimInstance(this);
-		AnimationIndex = owner_enemy_unit->GetAnimationIndex();
+		m_pending_snapshot.animation_index = owner_enemy_unit->GetAnimationIndex();
+		m_pending_snapshot.owned_fields |= FVEN_AnimationSnapshot::SPEED | FVEN_AnimationSnapshot::ANIMATION_INDEX;
 		return;
 	}
 
@@ -203,7 +305,7 @@ bool UVEN_AnimInstance::TryToStopActiveAction()
 	}
 	else if (m_active_action == ANIMATION_ACTION::PICK_ITEM && m_active_action_can_be_force_stopped)
 	{
-		PickItem = false;
+		LowerTrigger(FVEN_AnimationSnapshot::PICK_ITEM);
 		ResetActiveAction();
 		return true;
 	}
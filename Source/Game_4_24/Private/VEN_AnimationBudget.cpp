@@ -0,0 +1,214 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "VEN_AnimationBudget.h"
+#include "VEN_GameMode.h"
+#include "VEN_EnemyUnit.h"
+#include "VEN_AnimInstance.h"
+#include "VEN_Stats.h"
+
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Animation Budget Update"), STAT_VEN_AnimationBudgetUpdate, STATGROUP_Vendetta);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Animation Budget Full Rate"), STAT_VEN_AnimationBudgetFullRate, STATGROUP_Vendetta);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Animation Budget Reduced Rate"), STAT_VEN_AnimationBudgetReducedRate, STATGROUP_Vendetta);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Animation Budget Pose Followers"), STAT_VEN_AnimationBudgetPoseFollowers, STATGROUP_Vendetta);
+
+using namespace vendetta;
+
+namespace
+{
+	constexpr const float UPDATE_INTERVAL = .25f;
+	//frames skipped between evaluations of characters over the budget
+	constexpr const int32 FRAME_SKIPS[(int32)SIGNIFICANCE::COUNT] = { 0, 1, 2, 3 };
+	//pose comes from the leader, own evaluation is kept as rare as possible
+	constexpr const int32 FOLLOWER_FRAME_SKIP = 7;
+	constexpr const int32 MAX_LODS_COUNT = 8;
+
+	TAutoConsoleVariable<int32> CVAR_ANIMATION_BUDGET(
+		TEXT("ven.AnimationBudget"),
+		12,
+		TEXT("How many npcs and enemy units may evaluate animation every frame, battle participants are never limited."),
+		ECVF_Default);
+}
+
+UVEN_AnimationBudget::UVEN_AnimationBudget()
+	: m_time_to_update(0.f)
+	, m_is_initialized(false)
+{
+
+}
+
+void UVEN_AnimationBudget::Initialize()
+{
+	Uninitialize();
+	m_is_initialized = true;
+}
+
+void UVEN_AnimationBudget::Uninitialize()
+{
+	for (int32 i = 0; i < m_characters.Num(); ++i)
+	{
+		if (IsValid(m_characters[i]))
+			ApplyState(m_characters[i], m_states[i], 0, nullptr);
+	}
+
+	m_is_initialized = false;
+	m_characters.Empty();
+	m_states.Empty();
+	m_time_to_update = 0.f;
+}
+
+void UVEN_AnimationBudget::RegisterCharacter(ACharacter* character)
+{
+	if (!character || !character->GetMesh() || m_characters.Contains(character))
+		return;
+
+	m_characters.Add(character);
+	m_states.AddDefaulted();
+}
+
+void UVEN_AnimationBudget::Tick(float DeltaTime)
+{
+	m_time_to_update -= DeltaTime;
+	if (m_time_to_update > 0.f)
+		return;
+
+	m_time_to_update = UPDATE_INTERVAL;
+	UpdateBudget();
+}
+
+bool UVEN_AnimationBudget::IsTickable() const
+{
+	return m_is_initialized;
+}
+
+TStatId UVEN_AnimationBudget::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UVEN_AnimationBudget, STATGROUP_Tickables);
+}
+
+AVEN_GameMode* UVEN_AnimationBudget::GetGameMode() const
+{
+	const auto& world = GetWorld();
+	const auto& game_mode = world ? Cast<AVEN_GameMode>(world->GetAuthGameMode()) : nullptr;
+	//if (!game_mode)
+		//debug_log("UVEN_AnimationBudget::GetGameMode. Game Mode not found!", FColor::Red);
+
+	return game_mode;
+}
+
+void UVEN_AnimationBudget::UpdateBudget()
+{
+	SCOPE_CYCLE_COUNTER(STAT_VEN_AnimationBudgetUpdate);
+
+	const auto& game_mode = GetGameMode();
+	if (!game_mode || !game_mode->GetSignificanceManager())
+		return;
+
+	const auto& significance_manager = game_mode->GetSignificanceManager();
+	const FVector focus_location = game_mode->GetMainCameraRoot() ? game_mode->GetMainCameraRoot()->GetComponentLocation() : FVector::ZeroVector;
+
+	for (int32 i = m_characters.Num() - 1; i >= 0; --i)
+	{
+		if (!IsValid(m_characters[i]))
+		{
+			m_characters.RemoveAtSwap(i);
+			m_states.RemoveAtSwap(i);
+		}
+	}
+
+	TArray<FCandidate> candidates;
+	candidates.Reserve(m_characters.Num());
+	for (int32 i = 0; i < m_characters.Num(); ++i)
+		candidates.Add({ i, significance_manager->GetSignificance(m_characters[i]), FVector::DistSquared(m_characters[i]->GetActorLocation(), focus_location) });
+
+	candidates.Sort([](const FCandidate& first, const FCandidate& second)
+	{
+		return first.significance != second.significance ? first.significance < second.significance : first.distance_squared < second.distance_squared;
+	});
+
+	const int32 budget = FMath::Max(CVAR_ANIMATION_BUDGET.GetValueOnGameThread(), 0);
+	int32 full_rate_count = 0;
+	int32 reduced_rate_count = 0;
+	int32 followers_count = 0;
+	//best ranked idle character of every pose leads the rest of them
+	TMap<FIdlePoseKey, USkinnedMeshComponent*> leaders;
+
+	for (const auto& candidate : candidates)
+	{
+		const auto& character = m_characters[candidate.index];
+		auto& state = m_states[candidate.index];
+
+		if (candidate.significance == SIGNIFICANCE::CRITICAL || full_rate_count < budget)
+		{
+			ApplyState(character, state, 0, nullptr);
+			full_rate_count++;
+			continue;
+		}
+
+		FIdlePoseKey key;
+		if (candidate.significance >= SIGNIFICANCE::MEDIUM && GetIdlePoseKey(character, key))
+		{
+			const auto leader = leaders.Find(key);
+			if (leader)
+			{
+				ApplyState(character, state, FOLLOWER_FRAME_SKIP, *leader);
+				followers_count++;
+				continue;
+			}
+
+			leaders.Add(key, character->GetMesh());
+		}
+
+		ApplyState(character, state, FRAME_SKIPS[(int32)candidate.significance], nullptr);
+		reduced_rate_count++;
+	}
+
+	SET_DWORD_STAT(STAT_VEN_AnimationBudgetFullRate, full_rate_count);
+	SET_DWORD_STAT(STAT_VEN_AnimationBudgetReducedRate, reduced_rate_count);
+	SET_DWORD_STAT(STAT_VEN_AnimationBudgetPoseFollowers, followers_count);
+}
+
+bool UVEN_AnimationBudget::GetIdlePoseKey(const ACharacter* character, FIdlePoseKey& key) const
+{
+	const auto& mesh = character->GetMesh();
+	const auto& anim_instance = Cast<UVEN_AnimInstance>(mesh->GetAnimInstance());
+	if (!mesh->SkeletalMesh || !anim_instance || !anim_instance->IsFree())
+		return false;
+
+	//dead units are idle too, but they lie on the ground
+	const auto& enemy_unit = Cast<AVEN_EnemyUnit>(character);
+	if (enemy_unit && enemy_unit->IsDead())
+		return false;
+
+	//index the graph plays, npc graphs set it by themselves and it never goes through the snapshot
+	key = FIdlePoseKey(mesh->SkeletalMesh, anim_instance->GetClass(), anim_instance->AnimationIndex);
+	return true;
+}
+
+void UVEN_AnimationBudget::ApplyState(ACharacter* character, FCharacterState& state, int32 frame_skip, USkinnedMeshComponent* leader)
+{
+	const auto& mesh = character->GetMesh();
+
+	if (state.leader.Get() != leader)
+	{
+		mesh->SetMasterPoseComponent(leader);
+		state.leader = leader;
+	}
+
+	if (state.frame_skip == frame_skip || !mesh->AnimUpdateRateParams)
+		return;
+
+	//lod map replaces screen size based rates, every lod gets the rate of the budget
+	auto& update_rate_params = *mesh->AnimUpdateRateParams;
+	update_rate_params.bShouldUseLodMap = true;
+	update_rate_params.MaxEvalRateForInterpolation = FOLLOWER_FRAME_SKIP + 2;
+	for (int32 lod = 0; lod < MAX_LODS_COUNT; ++lod)
+		update_rate_params.LODToFrameSkipMap.Add(lod, frame_skip);
+
+	state.frame_skip = frame_skip;
+}
\ No newline at end of file
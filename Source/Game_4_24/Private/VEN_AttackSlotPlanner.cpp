@@ -0,0 +1,349 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "VEN_AttackSlotPlanner.h"
+#include "VEN_GameMode.h"
+#include "VEN_BattleInstance.h"
+#include "VEN_EnemyUnit.h"
+#include "VEN_PlayerUnit.h"
+#include "VEN_FreeFunctions.h"
+#include "VEN_Stats.h"
+
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Attack Slots Assignment"), STAT_VEN_AttackSlotsAssignment, STATGROUP_Vendetta);
+
+using namespace vendetta;
+
+namespace
+{
+	constexpr const int32 SLOTS_PER_PLAYER_UNIT = 4;
+	constexpr const float SLOT_ANGLE_STEP = 90.f;
+	constexpr const float MIN_DISTANCE_BETWEEN_UNIT_AND_SLOT = 100.f;
+	constexpr const float PLAYER_UNIT_MOVEMENT_TOLERANCE = 10.f;
+	constexpr const float UNREACHABLE_SLOT_COST = 1000000.f;
+
+	//minimal cost assignment of rows to columns (hungarian algorithm), requires rows_count <= columns_count
+	void solve_assignment(const TArray<float>& costs, int32 rows_count, int32 columns_count, TArray<int32>& row_to_column)
+	{
+		TArray<float> u, v, min_values;
+		TArray<int32> column_to_row, way;
+		TArray<bool> used;
+		u.Init(0.f, rows_count + 1);
+		v.Init(0.f, columns_count + 1);
+		column_to_row.Init(0, columns_count + 1);
+		way.Init(0, columns_count + 1);
+
+		for (int32 i = 1; i <= rows_count; ++i)
+		{
+			column_to_row[0] = i;
+			int32 j0 = 0;
+			min_values.Init(MAX_flt, columns_count + 1);
+			used.Init(false, columns_count + 1);
+
+			do
+			{
+				used[j0] = true;
+				const int32 i0 = column_to_row[j0];
+				float delta = MAX_flt;
+				int32 j1 = 0;
+
+				for (int32 j = 1; j <= columns_count; ++j)
+				{
+					if (used[j])
+						continue;
+
+					const float current = costs[(i0 - 1) * columns_count + (j - 1)] - u[i0] - v[j];
+					if (current < min_values[j])
+					{
+						min_values[j] = current;
+						way[j] = j0;
+					}
+					if (min_values[j] < delta)
+					{
+						delta = min_values[j];
+						j1 = j;
+					}
+				}
+
+				for (int32 j = 0; j <= columns_count; ++j)
+				{
+					if (used[j])
+					{
+						u[column_to_row[j]] += delta;
+						v[j] -= delta;
+					}
+					else
+					{
+						min_values[j] -= delta;
+					}
+				}
+
+				j0 = j1;
+			} while (column_to_row[j0] != 0);
+
+			do
+			{
+				const int32 j1 = way[j0];
+				column_to_row[j0] = column_to_row[j1];
+				j0 = j1;
+			} while (j0);
+		}
+
+		row_to_column.Init(INDEX_NONE, rows_count);
+		for (int32 j = 1; j <= columns_count; ++j)
+		{
+			if (column_to_row[j])
+				row_to_column[column_to_row[j] - 1] = j - 1;
+		}
+	}
+}
+
+UVEN_AttackSlotPlanner::UVEN_AttackSlotPlanner()
+	: m_pending_paths_batches_count(0)
+	, m_planning_in_progress(false)
+	, m_plan_is_ready(false)
+{
+
+}
+
+void UVEN_AttackSlotPlanner::Initialize()
+{
+	CancelPlanning();
+	m_requests.Empty();
+	m_plan_is_ready = false;
+}
+
+void UVEN_AttackSlotPlanner::Invalidate()
+{
+	CancelPlanning();
+	m_plan_is_ready = false;
+
+	if (m_requests.Num())
+		StartPlanning();
+}
+
+void UVEN_AttackSlotPlanner::RequestAssignment(AVEN_EnemyUnit* enemy_unit, const FVEN_OnAttackSlotAssigned& callback)
+{
+	if (!enemy_unit)
+		return;
+
+	m_requests.Add(enemy_unit, callback);
+
+	if (m_plan_is_ready && IsPlanValid())
+		ResolveRequests();
+	else if (!m_planning_in_progress)
+		StartPlanning();
+}
+
+void UVEN_AttackSlotPlanner::CancelRequest(AVEN_EnemyUnit* enemy_unit)
+{
+	m_requests.Remove(enemy_unit);
+}
+
+AVEN_GameMode* UVEN_AttackSlotPlanner::GetGameMode() const
+{
+	const auto& game_mode = Cast<AVEN_GameMode>(GetWorld()->GetAuthGameMode());
+	//if (!game_mode)
+		//debug_log("UVEN_AttackSlotPlanner::GetGameMode. Game Mode not found!", FColor::Red);
+
+	return game_mode;
+}
+
+UVEN_BattleInstance* UVEN_AttackSlotPlanner::GetBattle() const
+{
+	//every battle instance owns its planner
+	return Cast<UVEN_BattleInstance>(GetOuter());
+}
+
+bool UVEN_AttackSlotPlanner::IsPlanValid() const
+{
+	//plan is outdated when player units moved or died
+	for (int i = 0; i < m_player_units.Num(); ++i)
+	{
+		const auto& player_unit_c = Cast<AVEN_PlayerUnit>(m_player_units[i]);
+		if (!player_unit_c || player_unit_c->IsDead())
+			return false;
+
+		const auto& transform = m_player_units_transforms[i];
+		if (calculate_distance(player_unit_c->GetActorLocation(), transform.GetLocation()) > PLAYER_UNIT_MOVEMENT_TOLERANCE ||
+			!FMath::IsNearlyEqual(player_unit_c->GetActorRotation().Yaw, transform.Rotator().Yaw, 1.f))
+			return false;
+	}
+
+	return true;
+}
+
+void UVEN_AttackSlotPlanner::StartPlanning()
+{
+	CancelPlanning();
+	m_plan_is_ready = false;
+
+	m_enemy_units.Empty();
+	m_player_units.Empty();
+	m_player_units_transforms.Empty();
+
+	const auto& battle = GetBattle();
+	const auto& navigation_service = GetGameMode() ? GetGameMode()->GetNavigationService() : nullptr;
+	if (!battle || !navigation_service)
+	{
+		//debug_log("UVEN_AttackSlotPlanner::StartPlanning. Battle System or Navigation Service not found!", FColor::Red);
+		FinishPlanning();
+		return;
+	}
+
+	for (const auto& enemy_unit : battle->GetEnemyUnitsInBattle())
+	{
+		const auto& enemy_unit_c = Cast<AVEN_EnemyUnit>(enemy_unit);
+		if (enemy_unit_c && !enemy_unit_c->IsDead())
+			m_enemy_units.Add(enemy_unit_c);
+	}
+
+	for (const auto& player_unit : battle->GetPlayerUnitsInBattle())
+	{
+		const auto& player_unit_c = Cast<AVEN_PlayerUnit>(player_unit);
+		if (!player_unit_c || player_unit_c->IsDead())
+			continue;
+
+		m_player_units.Add(player_unit);
+		m_player_units_transforms.Add(player_unit->GetTransform());
+	}
+
+	const int32 slots_count = m_player_units.Num() * SLOTS_PER_PLAYER_UNIT;
+	m_slots_points.Init(FVector::ZeroVector, m_enemy_units.Num() * slots_count);
+	m_slots_costs.Init(UNREACHABLE_SLOT_COST, m_enemy_units.Num() * slots_count);
+
+	if (!m_enemy_units.Num() || !slots_count)
+	{
+		FinishPlanning();
+		return;
+	}
+
+	//every enemy unit evaluates its own slots points (they depend on its attack range) with one paths batch
+	m_planning_in_progress = true;
+	m_pending_paths_batches_count = m_enemy_units.Num();
+
+	for (int32 enemy_unit_index = 0; enemy_unit_index < m_enemy_units.Num(); ++enemy_unit_index)
+	{
+		const auto& enemy_unit = m_enemy_units[enemy_unit_index];
+		TArray<FVector> points;
+		TArray<int32> slots_indices;
+
+		for (int32 slot_index = 0; slot_index < slots_count; ++slot_index)
+		{
+			const auto& player_unit_transform = m_player_units_transforms[slot_index / SLOTS_PER_PLAYER_UNIT];
+			const float angle = SLOT_ANGLE_STEP * (slot_index % SLOTS_PER_PLAYER_UNIT) + player_unit_transform.Rotator().Yaw;
+			const FVector point = player_unit_transform.GetLocation() + FVector(enemy_unit->GetAttackRange(), 0.f, 0.f).RotateAngleAxis(angle, FVector(0, 0, 1));
+
+			m_slots_points[enemy_unit_index * slots_count + slot_index] = point;
+			if (!IsSlotPointFree(point, enemy_unit))
+				continue;
+
+			points.Add(point);
+			slots_indices.Add(slot_index);
+		}
+
+		m_paths_batches.Add(navigation_service->FindPathsAsync(enemy_unit, points,
+			FVEN_OnPathBatchCompleted::CreateUObject(this, &UVEN_AttackSlotPlanner::OnEnemyUnitPathsEvaluated, enemy_unit_index, slots_indices)));
+	}
+}
+
+void UVEN_AttackSlotPlanner::CancelPlanning()
+{
+	const auto& navigation_service = GetGameMode() ? GetGameMode()->GetNavigationService() : nullptr;
+	if (navigation_service)
+	{
+		for (const auto& batch_id : m_paths_batches)
+			navigation_service->CancelPathsBatch(batch_id);
+	}
+
+	m_paths_batches.Empty();
+	m_pending_paths_batches_count = 0;
+	m_planning_in_progress = false;
+}
+
+bool UVEN_AttackSlotPlanner::IsSlotPointFree(const FVector& point, const AActor* slot_owner) const
+{
+	const auto& battle = GetBattle();
+	if (!battle)
+		return false;
+
+	for (const auto& in_battle_unit : battle->GetAllUnitsInBattle())
+	{
+		if (in_battle_unit != slot_owner && calculate_distance(point, in_battle_unit->GetActorLocation()) <= MIN_DISTANCE_BETWEEN_UNIT_AND_SLOT)
+			return false;
+	}
+
+	return true;
+}
+
+void UVEN_AttackSlotPlanner::OnEnemyUnitPathsEvaluated(const TArray<FVEN_PathQueryResult>& results, int32 enemy_unit_index, TArray<int32> slots_indices)
+{
+	if (!m_planning_in_progress)
+		return;
+
+	const int32 slots_count = m_player_units.Num() * SLOTS_PER_PLAYER_UNIT;
+	for (int i = 0; i < results.Num() && i < slots_indices.Num(); ++i)
+	{
+		if (results[i].is_reachable)
+			m_slots_costs[enemy_unit_index * slots_count + slots_indices[i]] = results[i].path_length;
+	}
+
+	m_pending_paths_batches_count--;
+	if (m_pending_paths_batches_count <= 0)
+		FinishPlanning();
+}
+
+void UVEN_AttackSlotPlanner::FinishPlanning()
+{
+	SCOPE_CYCLE_COUNTER(STAT_VEN_AttackSlotsAssignment);
+
+	m_paths_batches.Empty();
+	m_planning_in_progress = false;
+	m_plan_is_ready = true;
+
+	const int32 enemy_units_count = m_enemy_units.Num();
+	const int32 slots_count = m_player_units.Num() * SLOTS_PER_PLAYER_UNIT;
+	m_assigned_slots.Init(FVEN_AttackSlot(), enemy_units_count);
+
+	if (enemy_units_count && slots_count)
+	{
+		//more enemy units than slots - extra columns leave some units without slot
+		const int32 columns_count = FMath::Max(slots_count, enemy_units_count);
+		TArray<float> costs;
+		costs.Init(UNREACHABLE_SLOT_COST, enemy_units_count * columns_count);
+		for (int32 row = 0; row < enemy_units_count; ++row)
+		{
+			for (int32 column = 0; column < slots_count; ++column)
+				costs[row * columns_count + column] = m_slots_costs[row * slots_count + column];
+		}
+
+		TArray<int32> row_to_column;
+		solve_assignment(costs, enemy_units_count, columns_count, row_to_column);
+
+		for (int32 row = 0; row < enemy_units_count; ++row)
+		{
+			const int32 slot_index = row_to_column[row];
+			if (slot_index == INDEX_NONE || slot_index >= slots_count || m_slots_costs[row * slots_count + slot_index] >= UNREACHABLE_SLOT_COST)
+				continue;
+
+			m_assigned_slots[row].target = m_player_units[slot_index / SLOTS_PER_PLAYER_UNIT];
+			m_assigned_slots[row].point = m_slots_points[row * slots_count + slot_index];
+		}
+	}
+
+	ResolveRequests();
+}
+
+void UVEN_AttackSlotPlanner::ResolveRequests()
+{
+	auto requests = MoveTemp(m_requests);
+	m_requests.Empty();
+
+	for (const auto& request : requests)
+	{
+		const int32 enemy_unit_index = m_enemy_units.Find(request.Key);
+		const FVEN_AttackSlot slot = m_assigned_slots.IsValidIndex(enemy_unit_index) ? m_assigned_slots[enemy_unit_index] : FVEN_AttackSlot();
+		request.Value.ExecuteIfBound(slot);
+	}
+}
\ No newline at end of file
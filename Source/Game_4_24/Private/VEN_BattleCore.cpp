@@ -0,0 +1,267 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "VEN_BattleCore.h"
+
+using namespace vendetta;
+
+FVEN_BattleCore::FVEN_BattleCore()
+	: m_round_starter(INDEX_NONE)
+	, m_in_progress(false)
+	, m_game_over(false)
+{
+
+}
+
+void FVEN_BattleCore::Reset()
+{
+	m_units.Empty();
+	m_queue.Reset();
+	m_units_to_remove.Empty();
+	m_died_units.Empty();
+	m_round_starter = INDEX_NONE;
+	m_in_progress = false;
+	m_game_over = false;
+}
+
+int32 FVEN_BattleCore::AddUnit(const FVEN_BattleUnitRecord& record)
+{
+	const int32 handle = m_units.Add(record);
+	m_queue.Add(handle);
+	if (record.is_dead)
+		m_units_to_remove.Add(handle);
+
+	return handle;
+}
+
+void FVEN_BattleCore::Start()
+{
+	m_in_progress = true;
+	m_round_starter = GetCurrentTurnOwner();
+}
+
+void FVEN_BattleCore::Finish()
+{
+	m_in_progress = false;
+}
+
+bool FVEN_BattleCore::IsInProgress() const
+{
+	return m_in_progress;
+}
+
+bool FVEN_BattleCore::IsGameOver() const
+{
+	return m_game_over;
+}
+
+const FVEN_BattleUnitRecord& FVEN_BattleCore::GetUnit(int32 handle) const
+{
+	return m_units[handle];
+}
+
+int32 FVEN_BattleCore::GetUnitsCount() const
+{
+	return m_units.Num();
+}
+
+const FVEN_TurnQueue& FVEN_BattleCore::GetQueue() const
+{
+	return m_queue;
+}
+
+const TArray<int32>& FVEN_BattleCore::GetDiedUnits() const
+{
+	return m_died_units;
+}
+
+int32 FVEN_BattleCore::GetCurrentTurnOwner() const
+{
+	return m_queue.GetHead();
+}
+
+bool FVEN_BattleCore::IsRoundStarterTurn() const
+{
+	return GetCurrentTurnOwner() == m_round_starter;
+}
+
+int FVEN_BattleCore::RollAttackPower(int32 handle, FRandomStream& random_stream) const
+{
+	const auto& unit = m_units[handle];
+	return random_stream.RandRange(unit.attack_power_min, unit.attack_power_max);
+}
+
+FVEN_BattleAttackResult FVEN_BattleCore::Attack(int32 attacker, int32 defender, int damage)
+{
+	FVEN_BattleAttackResult result;
+	result.damage = damage;
+
+	if (!m_units.IsValidIndex(attacker) || !m_units.IsValidIndex(defender))
+		return result;
+
+	ApplyDamage(defender, damage);
+
+	if (!m_units[defender].is_dead)
+		return result;
+
+	result.defender_died = true;
+
+	if (CanBattleBeFinished())
+	{
+		result.battle_can_be_finished = true;
+		return result;
+	}
+
+	if (defender == m_round_starter)
+		ShiftRoundStarter();
+
+	return result;
+}
+
+void FVEN_BattleCore::UpdateTurnPoints(int32 handle, float update_on_value)
+{
+	auto& unit = m_units[handle];
+	unit.turn_points_left = FMath::Clamp(unit.turn_points_left + update_on_value, 0.f, unit.turn_points_total);
+}
+
+void FVEN_BattleCore::ResetAllTurnPoints()
+{
+	for (const auto& handle : m_queue)
+		m_units[handle].turn_points_left = m_units[handle].turn_points_total;
+}
+
+void FVEN_BattleCore::RemoveDiedUnits()
+{
+	for (const auto& handle : m_units_to_remove)
+	{
+		m_queue.Remove(handle);
+		m_died_units.AddUnique(handle);
+	}
+
+	m_units_to_remove.Empty();
+}
+
+bool FVEN_BattleCore::CanBattleBeFinished()
+{
+	int player_units_left = 0;
+	int enemy_units_left = 0;
+
+	for (const auto& handle : m_queue)
+	{
+		const auto& unit = m_units[handle];
+		if (unit.is_dead)
+			continue;
+
+		if (unit.faction == BATTLE_FACTION::PLAYER)
+			player_units_left++;
+		else
+			enemy_units_left++;
+	}
+
+	if (!player_units_left)
+	{
+		m_game_over = true;
+		return true;
+	}
+
+	return enemy_units_left == 0;
+}
+
+void FVEN_BattleCore::ShiftQueue()
+{
+	m_queue.Advance();
+}
+
+bool FVEN_BattleCore::FinishCurrentTurn()
+{
+	RemoveDiedUnits();
+
+	if (CanBattleBeFinished())
+	{
+		Finish();
+		return true;
+	}
+
+	ShiftQueue();
+	return false;
+}
+
+FVEN_BattleSimulationResult FVEN_BattleCore::Simulate(FRandomStream& random_stream, int max_turns)
+{
+	FVEN_BattleSimulationResult result;
+
+	Start();
+	while (m_in_progress && result.turns < max_turns)
+	{
+		ResetAllTurnPoints();
+		PlayAutomaticTurn(random_stream);
+		FinishCurrentTurn();
+		result.turns++;
+	}
+
+	result.is_finished = !m_in_progress;
+	result.winner = m_game_over ? BATTLE_FACTION::ENEMY : BATTLE_FACTION::PLAYER;
+	return result;
+}
+
+void FVEN_BattleCore::ApplyDamage(int32 handle, int damage)
+{
+	auto& unit = m_units[handle];
+	unit.hp_current -= damage;
+
+	if (unit.hp_current > unit.hp_total)
+	{
+		unit.hp_current = unit.hp_total;
+	}
+	else if (unit.hp_current <= unit.hp_on_defeat)
+	{
+		unit.hp_current = unit.hp_on_defeat;
+		if (!unit.is_dead)
+			m_units_to_remove.Add(handle);
+		unit.is_dead = true;
+	}
+}
+
+void FVEN_BattleCore::ShiftRoundStarter()
+{
+	if (m_queue.Contains(m_round_starter))
+		m_round_starter = m_queue.GetNext(m_round_starter);
+}
+
+int32 FVEN_BattleCore::FindWeakestOpponent(int32 handle) const
+{
+	int32 weakest_opponent = INDEX_NONE;
+
+	for (const auto& other_handle : m_queue)
+	{
+		const auto& other_unit = m_units[other_handle];
+		if (other_unit.is_dead || other_unit.faction == m_units[handle].faction)
+			continue;
+
+		if (weakest_opponent == INDEX_NONE || other_unit.hp_current < m_units[weakest_opponent].hp_current)
+			weakest_opponent = other_handle;
+	}
+
+	return weakest_opponent;
+}
+
+void FVEN_BattleCore::PlayAutomaticTurn(FRandomStream& random_stream)
+{
+	const int32 owner = GetCurrentTurnOwner();
+	if (owner == INDEX_NONE)
+		return;
+
+	const auto& owner_unit = m_units[owner];
+	while (owner_unit.turn_points_left >= owner_unit.attack_price)
+	{
+		const int32 target = FindWeakestOpponent(owner);
+		if (target == INDEX_NONE)
+			return;
+
+		const auto result = Attack(owner, target, RollAttackPower(owner, random_stream));
+		UpdateTurnPoints(owner, -owner_unit.attack_price);
+
+		if (result.battle_can_be_finished || owner_unit.attack_price <= 0.f)
+			return;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,808 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "VEN_BattleInstance.h"
+#include "VEN_BattleSystem.h"
+#include "VEN_GameMode.h"
+#include "VEN_PlayerUnit.h"
+#include "VEN_EnemyUnit.h"
+#include "VEN_MainController.h"
+#include "VEN_AttackSlotPlanner.h"
+#include "VEN_LineOfSightGrid.h"
+#include "VEN_FreeFunctions.h"
+#include "VEN_Stats.h"
+
+#include "GameFramework/Actor.h"
+#include "GameFramework/Character.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+#include "Engine.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "NavigationSystem.h"
+#include "NavMesh/RecastNavMesh.h"
+#include "Detour/DetourNavMesh.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("NavMesh Tiles Rebuilt Per Turn"), STAT_VEN_NavMeshTilesRebuiltPerTurn, STATGROUP_Vendetta);
+DEFINE_LOG_CATEGORY_STATIC(LogVENBattle, Log, All);
+
+using namespace vendetta;
+
+namespace
+{
+	constexpr const float NERBY_UNITS_SPHERE_RADIUS = 3000.f;
+	constexpr const float NERBY_UNITS_HEIGHT_DELTA = 100.f;
+	constexpr const float DELAY_BETWEEN_TURNS = 1.f;
+
+	TAutoConsoleVariable<int32> CVAR_BATTLE_SEED(
+		TEXT("ven.BattleSeed"),
+		0,
+		TEXT("Seed of combat rolls for battles started from now on, 0 picks a random seed. Every battle logs its seed."),
+		ECVF_Cheat);
+
+#if !UE_BUILD_SHIPPING
+	//replays are a debugging tool, files are never pruned so recording is opt-in
+	TAutoConsoleVariable<int32> CVAR_RECORD_BATTLES(
+		TEXT("ven.RecordBattles"),
+		0,
+		TEXT("1 writes every battle started from now on into Saved/BattleReplays, replay it with ven.ReplayBattle. Not available in shipping builds."),
+		ECVF_Cheat);
+#endif
+}
+
+UVEN_BattleInstance::UVEN_BattleInstance()
+	: m_battle_system(nullptr)
+	, m_attack_slot_planner(nullptr)
+	, m_line_of_sight_grid(nullptr)
+	, m_is_player_battle(false)
+	, m_is_turn_in_progress(false)
+	, m_battle_state_revision(0)
+	, m_random_seed(0)
+{
+
+}
+
+void UVEN_BattleInstance::Initialize(UVEN_BattleSystem* battle_system)
+{
+	m_battle_system = battle_system;
+	m_battle_core.Reset();
+	ClearBattleUnits();
+	m_is_player_battle = false;
+	m_is_turn_in_progress = false;
+
+	if (!m_attack_slot_planner)
+		m_attack_slot_planner = NewObject<UVEN_AttackSlotPlanner>(this, UVEN_AttackSlotPlanner::StaticClass(), FName("attack_slot_planner"));
+	m_attack_slot_planner->Initialize();
+
+	if (!m_line_of_sight_grid)
+		m_line_of_sight_grid = NewObject<UVEN_LineOfSightGrid>(this, UVEN_LineOfSightGrid::StaticClass(), FName("line_of_sight_grid"));
+	m_line_of_sight_grid->Initialize(this);
+}
+
+void UVEN_BattleInstance::Uninitialize()
+{
+	const auto& game_mode = GetGameMode();
+	if (!game_mode)
+		return;
+
+	if (m_battle_core.IsInProgress())
+	{
+		game_mode->GetWorld()->GetTimerManager().ClearTimer(m_tmr_before_next_turn);
+		m_battle_core.Finish();
+	}
+
+	//unfinished battle keeps everything recorded so far
+	FlushReplayRecording(true);
+	if (m_line_of_sight_grid)
+		m_line_of_sight_grid->Reset();
+}
+
+bool UVEN_BattleInstance::IsBattleInProgress() const
+{
+	return m_battle_core.IsInProgress();
+}
+
+bool UVEN_BattleInstance::IsGameOver() const
+{
+	return m_battle_core.IsGameOver();
+}
+
+bool UVEN_BattleInstance::IsPlayerBattle() const
+{
+	return m_is_player_battle;
+}
+
+void UVEN_BattleInstance::Notify(BATTLE_NOTIFY_TYPE notification)
+{
+	if (notification == BATTLE_NOTIFY_TYPE::START_BATTLE || notification == BATTLE_NOTIFY_TYPE::FINISH_BATTLE)
+	{
+		//notify main controller, it cares only about the first started and the last finished player battle
+		const int32 player_battles_count = m_battle_system->GetPlayerBattles().Num();
+		const bool notify_main_controller = m_is_player_battle && (notification == BATTLE_NOTIFY_TYPE::START_BATTLE ? player_battles_count == 1 : player_battles_count == 0);
+		const auto& main_controller = notify_main_controller ? GetMainController() : nullptr;
+		if (main_controller)
+		{
+			if (notification == BATTLE_NOTIFY_TYPE::START_BATTLE)
+				main_controller->OnStartBattle();
+			else if (notification == BATTLE_NOTIFY_TYPE::FINISH_BATTLE)
+				main_controller->OnFinishBattle();
+		}
+		else if (notify_main_controller)
+		{
+			//debug_log("UVEN_BattleInstance::Notify. Main Controller is nullptr", FColor::Red);
+			return;
+		}
+
+		//notify alive units
+		for (const auto& handle : m_battle_core.GetQueue())
+		{
+			const auto& participant = GetParticipantByHandle(handle);
+			if (!participant)
+			{
+				//debug_log("UVEN_BattleInstance::Notify. Invalid battle receiver", FColor::Red);
+				continue;
+			}
+
+			if (notification == BATTLE_NOTIFY_TYPE::START_BATTLE)
+				participant->OnStartBattle();
+			else if (notification == BATTLE_NOTIFY_TYPE::FINISH_BATTLE)
+				participant->OnFinishBattle();
+		}
+
+		//notify died units about finish battle separately
+		if (notification == BATTLE_NOTIFY_TYPE::FINISH_BATTLE)
+		{
+			for (const auto& handle : m_battle_core.GetDiedUnits())
+			{
+				const auto& participant = GetParticipantByHandle(handle);
+				if (participant)
+					participant->OnFinishBattle();
+			}
+		}
+	}
+	else if (notification == BATTLE_NOTIFY_TYPE::START_NEW_TURN || notification == BATTLE_NOTIFY_TYPE::FINISH_CURRENT_TURN)
+	{
+		const auto& participant = IsBattleInProgress() ? GetParticipantByHandle(m_battle_core.GetCurrentTurnOwner()) : nullptr;
+		if (!participant)
+		{
+			//debug_log("UVEN_BattleInstance::Notify. Invalid turn receiver", FColor::Red);
+			return;
+		}
+
+		if (notification == BATTLE_NOTIFY_TYPE::START_NEW_TURN)
+			participant->OnStartBattleTurn();
+		else if (notification == BATTLE_NOTIFY_TYPE::FINISH_CURRENT_TURN)
+			participant->OnFinishBattleTurn();
+	}
+}
+
+void UVEN_BattleInstance::StartBattle(AActor* attacker, AActor* defender)
+{
+	if (!attacker || !defender || !m_battle_system)
+	{
+		//debug_log("UVEN_BattleInstance::StartBattle. Attacker, Defender or Battle System is nullptr", FColor::Red);
+		return;
+	}
+
+	m_battle_core.Reset();
+	ClearBattleUnits();
+	m_is_turn_in_progress = false;
+
+	m_random_seed = CVAR_BATTLE_SEED.GetValueOnGameThread();
+	if (!m_random_seed)
+		m_random_seed = FMath::Rand();
+	m_random_stream.Initialize(m_random_seed);
+	UE_LOG(LogVENBattle, Log, TEXT("%s started with seed %d"), *GetName(), m_random_seed);
+
+	SetupBattleUnitsQueue(attacker, defender);
+	m_is_player_battle = m_player_units.Num() > 0;
+	//only player units ask for line of sight, other battles trace on demand
+	if (m_is_player_battle)
+		BuildLineOfSightGrid(attacker, defender);
+	m_battle_core.Start();
+	StartReplayRecording();
+	m_attack_slot_planner->Invalidate();
+	UpdateNavigationBlockers();
+	UpdateNavMeshTilesStat(true);
+	m_battle_system->OnBattleStarted(this);
+	Notify(BATTLE_NOTIFY_TYPE::START_BATTLE);
+	UpdateBlueprintBattleQueue();
+
+	//nobody waits for the start popup
+	if (!m_is_player_battle)
+	{
+		PrepareNextTurn();
+		return;
+	}
+
+	m_battle_system->RequestBattlePopup(this, EWidgetBattleRequestType::START_BATTLE);
+	GetGameMode()->OnAmbientMusicUpdate(EAmbientMusicType::INBATTLE_AMBIENT);
+}
+
+void UVEN_BattleInstance::FinishBattle()
+{
+	m_battle_core.Finish();
+	m_is_turn_in_progress = false;
+	m_replay.RecordFinish(IsGameOver());
+	FlushReplayRecording(true);
+	m_attack_slot_planner->Initialize();
+	m_line_of_sight_grid->Reset();
+
+	GetGameMode()->GetWorld()->GetTimerManager().ClearTimer(m_tmr_before_next_turn);
+
+	ResetAllTurnPoints();
+	UpdateNavigationBlockers();
+	m_battle_system->OnBattleFinished(this);
+	Notify(BATTLE_NOTIFY_TYPE::FINISH_BATTLE);
+
+	if (!m_is_player_battle)
+		return;
+
+	m_battle_system->RequestBattlePopup(this, IsGameOver() ? EWidgetBattleRequestType::DEFEAT : EWidgetBattleRequestType::VICTORY);
+
+	//other player battles keep the widgets and music
+	if (m_battle_system->GetPlayerBattle())
+		return;
+
+	GetGameMode()->GameModeOnBattleQueueChanged({});
+	GetGameMode()->OnAmbientMusicUpdate(EAmbientMusicType::COMMON_AMBIENT);
+}
+
+void UVEN_BattleInstance::Attack(AActor* attacker, AActor* defender)
+{
+	const auto& player_unit_attacker_c = Cast<AVEN_PlayerUnit>(attacker);
+	const auto& player_unit_defender_c = Cast<AVEN_PlayerUnit>(defender);
+	const auto& enemy_unit_attacker_c = Cast<AVEN_EnemyUnit>(attacker);
+	const auto& enemy_unit_defender_c = Cast<AVEN_EnemyUnit>(defender);
+
+	const int32 attacker_handle = m_battle_units.Find(attacker);
+	const int32 defender_handle = m_battle_units.Find(defender);
+	if (attacker_handle == INDEX_NONE || defender_handle == INDEX_NONE)
+	{
+		//debug_log("UVEN_BattleInstance::Attack. Attacker or Defender is not in battle!", FColor::Red);
+		return;
+	}
+
+	m_battle_state_revision++;
+
+	if (player_unit_attacker_c && enemy_unit_defender_c)
+	{
+		const auto& result = m_battle_core.Attack(attacker_handle, defender_handle, player_unit_attacker_c->GetRandomAttackPower(m_random_stream));
+		m_replay.RecordAttack(attacker_handle, defender_handle, result.damage);
+		if (result.defender_died)
+			m_replay.RecordDeath(defender_handle);
+		enemy_unit_defender_c->OnReceiveDamage(result.damage, player_unit_attacker_c);
+		GetGameMode()->OnWidgetFlyingDataUpdate(EWidgetFlyingDataType::NEGATIVE_DAMAGE, result.damage, enemy_unit_defender_c->GetMesh()->GetComponentLocation());
+
+		if (result.defender_died)
+		{
+			UpdateNavigationBlockers();
+			m_attack_slot_planner->Invalidate();
+		}
+		if (result.battle_can_be_finished)
+			FinishCurrentTurn(player_unit_attacker_c);
+	}
+	else if (enemy_unit_attacker_c && player_unit_defender_c)
+	{
+		const auto& result = m_battle_core.Attack(attacker_handle, defender_handle, enemy_unit_attacker_c->GetRandomAttackPower(m_random_stream));
+		m_replay.RecordAttack(attacker_handle, defender_handle, result.damage);
+		if (result.defender_died)
+			m_replay.RecordDeath(defender_handle);
+		player_unit_defender_c->OnReceiveDamage(result.damage, enemy_unit_attacker_c);
+		GetGameMode()->OnWidgetFlyingDataUpdate(EWidgetFlyingDataType::NEGATIVE_DAMAGE, result.damage, player_unit_defender_c->GetMesh()->GetComponentLocation());
+
+		if (result.defender_died)
+		{
+			UpdateNavigationBlockers();
+			m_attack_slot_planner->Invalidate();
+			enemy_unit_attacker_c->OnTargetDied();
+		}
+	}
+	else
+	{
+		//debug_log("UVEN_BattleInstance::Attack. Invalid attacker/defender!", FColor::Red);
+	}
+}
+
+void UVEN_BattleInstance::PrepareNextTurn()
+{
+	if (!IsBattleInProgress())
+		return;
+
+	if (!GetCurrentTurnOwner())
+	{
+		//debug_log("UVEN_BattleInstance::PrepareNextTurn. Cannot retrieve current turn owner", FColor::Red);
+		return;
+	}
+	if (!GetCurrentTurnOwner()->GetWorld())
+	{
+		//debug_log("UVEN_BattleInstance::PrepareNextTurn. Cannot retrieve world of current turn owner", FColor::Red);
+		return;
+	}
+
+	UpdateNavigationBlockers();
+	UpdateNavMeshTilesStat(false);
+
+	//attack slots are planned once per round
+	if (m_battle_core.IsRoundStarterTurn())
+		m_attack_slot_planner->Invalidate();
+
+	GetGameMode()->GetWorld()->GetTimerManager().ClearTimer(m_tmr_before_next_turn);
+	GetGameMode()->GetWorld()->GetTimerManager().SetTimer(m_tmr_before_next_turn, this, &UVEN_BattleInstance::StartNextTurn, DELAY_BETWEEN_TURNS);
+}
+
+void UVEN_BattleInstance::StartNextTurn()
+{
+	if (!IsBattleInProgress() || !GetCurrentTurnOwner())
+		return;
+
+	ResetAllTurnPoints();
+
+	m_is_turn_in_progress = true;
+	UpdateBlueprintBattleQueue();
+	Notify(BATTLE_NOTIFY_TYPE::START_NEW_TURN);
+	UpdateBlueprintTurnOwner();
+}
+
+void UVEN_BattleInstance::FinishCurrentTurn(AActor* requestor)
+{
+	if (requestor != GetCurrentTurnOwner())
+		return;
+
+	Notify(BATTLE_NOTIFY_TYPE::FINISH_CURRENT_TURN);
+	m_is_turn_in_progress = false;
+	UpdateBlueprintTurnOwner();
+	m_replay.RecordTurnEnd(m_battle_core.GetCurrentTurnOwner());
+	UpdateBattleUnitsQueue();
+	UpdateBlueprintBattleQueue();
+
+	if (CanBattleBeFinished())
+	{
+		FinishBattle();
+		if (IsGameOver())
+			Notify(BATTLE_NOTIFY_TYPE::GAME_OVER);
+
+		return;
+	}
+
+	FlushReplayRecording(false);
+	ShiftBattleUnitsQueue();
+	PrepareNextTurn();
+}
+
+void UVEN_BattleInstance::RecordMovement(AActor* unit, const FVector& start, const FVector& end)
+{
+	const int32 handle = m_battle_units.Find(unit);
+	if (handle != INDEX_NONE)
+		m_replay.RecordMove(handle, start, end);
+}
+
+const TArray<AActor*>& UVEN_BattleInstance::GetBattleUnits() const
+{
+	return m_battle_units;
+}
+
+TArray<AActor*> UVEN_BattleInstance::GetAllUnitsInBattle() const
+{
+	TArray<AActor*> all_units;
+	if (!IsBattleInProgress())
+		return all_units;
+
+	for (const auto& handle : m_battle_core.GetQueue())
+		all_units.Add(GetUnitByHandle(handle));
+
+	return all_units;
+}
+
+const TArray<AActor*>& UVEN_BattleInstance::GetPlayerUnitsInBattle() const
+{
+	static const TArray<AActor*> no_units;
+	return IsBattleInProgress() ? m_player_units : no_units;
+}
+
+const TArray<AActor*>& UVEN_BattleInstance::GetEnemyUnitsInBattle() const
+{
+	static const TArray<AActor*> no_units;
+	return IsBattleInProgress() ? m_enemy_units : no_units;
+}
+
+UVEN_AttackSlotPlanner* UVEN_BattleInstance::GetAttackSlotPlanner() const
+{
+	return m_attack_slot_planner;
+}
+
+UVEN_LineOfSightGrid* UVEN_BattleInstance::GetLineOfSightGrid() const
+{
+	return m_line_of_sight_grid;
+}
+
+const TArray<FVEN_NavigationBlocker>& UVEN_BattleInstance::GetNavigationBlockers() const
+{
+	return m_navigation_blockers;
+}
+
+uint32 UVEN_BattleInstance::GetBattleStateRevision() const
+{
+	return m_battle_state_revision;
+}
+
+int32 UVEN_BattleInstance::GetRandomSeed() const
+{
+	return m_random_seed;
+}
+
+FRandomStream& UVEN_BattleInstance::GetRandomStream()
+{
+	return m_random_stream;
+}
+
+bool UVEN_BattleInstance::IsCurrentTurnOwner(const AActor* actor) const
+{
+	return GetCurrentTurnOwner() == actor;
+}
+
+void UVEN_BattleInstance::UpdateBlueprintBattleQueue()
+{
+	//widgets show the oldest player battle only
+	const auto& battle_queue = m_battle_core.GetQueue();
+	if (m_battle_system->GetPlayerBattle() != this || !IsBattleInProgress() || !battle_queue.Num())
+		return;
+
+	const int FIXED_DRAWN_QUEUE_SIZE = 5;
+	TArray<FBattleQueueUnitInfo> normalized_queue;
+
+	//queue is a ring, drawn part simply follows it from current turn owner and wraps around
+	int32 handle = battle_queue.GetHead();
+	for (int i = 0; i < FIXED_DRAWN_QUEUE_SIZE; ++i)
+	{
+		normalized_queue.Add({});
+		auto& info = normalized_queue[normalized_queue.Num() - 1];
+
+		const auto& participant = GetParticipantByHandle(handle);
+		handle = battle_queue.GetNext(handle);
+
+		if (participant)
+			info = participant->GetBattleQueueUnitInfo();
+	}
+
+	GetGameMode()->GameModeOnBattleQueueChanged(normalized_queue);
+}
+
+void UVEN_BattleInstance::UpdateBlueprintWidgets()
+{
+	UpdateBlueprintBattleQueue();
+	UpdateBlueprintTurnOwner();
+}
+
+void UVEN_BattleInstance::SetupBattleUnitsQueue(AActor* attacker, AActor* defender)
+{
+	const auto& units_spatial_hash = GetGameMode()->GetUnitsSpatialHash();
+	if (!units_spatial_hash)
+	{
+		//debug_log("UVEN_BattleInstance::SetupBattleUnitsQueue. Units Spatial Hash is nullptr", FColor::Red);
+		return;
+	}
+
+	TArray<AActor*> ally_units;
+
+	if (Cast<AVEN_PlayerUnit>(attacker))
+		units_spatial_hash->GatherUnits(attacker->GetActorLocation(), NERBY_UNITS_SPHERE_RADIUS, ally_units, AVEN_PlayerUnit::StaticClass(), attacker);
+	else if (Cast<AVEN_EnemyUnit>(attacker))
+		units_spatial_hash->GatherUnits(attacker->GetActorLocation(), NERBY_UNITS_SPHERE_RADIUS, ally_units, AVEN_EnemyUnit::StaticClass(), attacker);
+
+	AddUnitToBattle(attacker);
+	for (auto ally_unit : ally_units)
+	{
+		//units already fighting elsewhere stay in their battle
+		if (m_battle_system->IsInBattle(ally_unit))
+			continue;
+
+		if (FMath::Abs(attacker->GetActorLocation().Z - ally_unit->GetActorLocation().Z) < NERBY_UNITS_HEIGHT_DELTA)
+			AddUnitToBattle(ally_unit);
+	}
+
+	ally_units.Reset();
+
+	if (Cast<AVEN_PlayerUnit>(defender))
+		units_spatial_hash->GatherUnits(defender->GetActorLocation(), NERBY_UNITS_SPHERE_RADIUS, ally_units, AVEN_PlayerUnit::StaticClass(), defender);
+	else if (Cast<AVEN_EnemyUnit>(defender))
+		units_spatial_hash->GatherUnits(defender->GetActorLocation(), NERBY_UNITS_SPHERE_RADIUS, ally_units, AVEN_EnemyUnit::StaticClass(), defender);
+
+	AddUnitToBattle(defender);
+	for (auto ally_unit : ally_units)
+	{
+		if (m_battle_system->IsInBattle(ally_unit))
+			continue;
+
+		if (FMath::Abs(defender->GetActorLocation().Z - ally_unit->GetActorLocation().Z) < NERBY_UNITS_HEIGHT_DELTA)
+			AddUnitToBattle(ally_unit);
+	}
+
+	int player_units_count = 0;
+	for (const auto& handle : m_battle_core.GetQueue())
+	{
+		if (m_battle_core.GetUnit(handle).faction == BATTLE_FACTION::PLAYER)
+			player_units_count++;
+	}
+
+	if (player_units_count < 2)
+		TeleportStragglerPlayerUnit();
+}
+
+void UVEN_BattleInstance::AddUnitToBattle(AActor* unit)
+{
+	//the only cast, later everything goes through participant and its cached faction
+	const auto& participant = Cast<IVEN_BattleParticipant>(unit);
+	if (!participant)
+	{
+		//debug_log("UVEN_BattleInstance::AddUnitToBattle. Invalid battle unit", FColor::Red);
+		return;
+	}
+
+	const auto record = participant->GetBattleUnitRecord();
+	m_battle_core.AddUnit(record);
+	m_battle_units.Add(unit);
+	m_participants.Add(participant);
+
+	if (record.faction == BATTLE_FACTION::PLAYER)
+		m_player_units.Add(unit);
+	else
+		m_enemy_units.Add(unit);
+}
+
+void UVEN_BattleInstance::ClearBattleUnits()
+{
+	m_battle_units.Empty();
+	m_participants.Empty();
+	m_player_units.Empty();
+	m_enemy_units.Empty();
+}
+
+void UVEN_BattleInstance::UpdateBattleUnitsQueue()
+{
+	const int32 died_units_count = m_battle_core.GetDiedUnits().Num();
+	m_battle_core.RemoveDiedUnits();
+
+	//only units removed from queue just now leave faction lists
+	const auto& died_units = m_battle_core.GetDiedUnits();
+	for (int32 i = died_units_count; i < died_units.Num(); ++i)
+	{
+		const auto& unit = GetUnitByHandle(died_units[i]);
+		if (m_battle_core.GetUnit(died_units[i]).faction == BATTLE_FACTION::PLAYER)
+			m_player_units.Remove(unit);
+		else
+			m_enemy_units.Remove(unit);
+	}
+}
+
+void UVEN_BattleInstance::ShiftBattleUnitsQueue()
+{
+	m_battle_core.ShiftQueue();
+}
+
+void UVEN_BattleInstance::UpdateBlueprintTurnOwner()
+{
+	if (m_battle_system->GetPlayerBattle() != this)
+		return;
+
+	if (m_is_turn_in_progress)
+		GetGameMode()->OnBattleTurnOwnerUpdate(true, m_battle_core.GetUnit(m_battle_core.GetCurrentTurnOwner()).faction == BATTLE_FACTION::PLAYER);
+	else
+		GetGameMode()->OnBattleTurnOwnerUpdate(false);
+}
+
+AActor* UVEN_BattleInstance::GetCurrentTurnOwner() const
+{
+	if (IsBattleInProgress())
+		return GetUnitByHandle(m_battle_core.GetCurrentTurnOwner());
+
+	//debug_log("UVEN_BattleInstance::GetCurrentTurnOwner. Battle is not in progress", FColor::Red);
+	return nullptr;
+}
+
+AActor* UVEN_BattleInstance::GetUnitByHandle(int32 handle) const
+{
+	if (m_battle_units.IsValidIndex(handle))
+		return m_battle_units[handle];
+
+	return nullptr;
+}
+
+IVEN_BattleParticipant* UVEN_BattleInstance::GetParticipantByHandle(int32 handle) const
+{
+	if (m_participants.IsValidIndex(handle))
+		return m_participants[handle];
+
+	return nullptr;
+}
+
+AVEN_GameMode* UVEN_BattleInstance::GetGameMode() const
+{
+	const auto& game_mode = Cast<AVEN_GameMode>(GetWorld()->GetAuthGameMode());
+	//if (!game_mode)
+		//debug_log("UVEN_BattleInstance::GetGameMode. Game Mode not found!", FColor::Red);
+
+	return game_mode;
+}
+
+AVEN_MainController* UVEN_BattleInstance::GetMainController() const
+{
+	const auto& game_mode = GetGameMode();
+	if (!GetGameMode())
+	{
+		//debug_log("UVEN_BattleInstance::GetMainController. Game Mode not found!", FColor::Red);
+		return nullptr;
+	}
+
+	const auto& main_controller = Cast<AVEN_MainController>(game_mode->GetMainController());
+	if (!main_controller)
+	{
+		//debug_log("UVEN_BattleInstance::GetMainController. Main Controller not found!", FColor::Red);
+	}
+
+	return main_controller;
+}
+
+void UVEN_BattleInstance::UpdateNavigationBlockers()
+{
+	m_navigation_blockers.Empty();
+	m_battle_state_revision++;
+	if (!IsBattleInProgress())
+		return;
+
+	for (const auto& handle : m_battle_core.GetQueue())
+	{
+		const auto& unit = GetUnitByHandle(handle);
+		const auto& unit_character_c = Cast<ACharacter>(unit);
+		if (!unit_character_c)
+		{
+			//debug_log("UVEN_BattleInstance::UpdateNavigationBlockers. Unit cannot be casted to ACharacter", FColor::Red);
+			continue;
+		}
+
+		if (unit == GetCurrentTurnOwner() || m_battle_core.GetUnit(handle).is_dead)
+			continue;
+
+		m_navigation_blockers.Add({ unit->GetActorLocation(), unit_character_c->GetCapsuleComponent()->GetScaledCapsuleRadius(), unit });
+	}
+}
+
+void UVEN_BattleInstance::BuildLineOfSightGrid(AActor* attacker, AActor* defender)
+{
+	//battle units were gathered around both sides, grid covers both spheres
+	const FVector center = (attacker->GetActorLocation() + defender->GetActorLocation()) * .5f;
+	const float radius = NERBY_UNITS_SPHERE_RADIUS + FVector::Dist2D(attacker->GetActorLocation(), defender->GetActorLocation()) * .5f;
+
+	//units are looking from their capsule center, pairs beyond the longest attack range are never asked
+	float eye_height = 0.f;
+	float max_distance = 0.f;
+	for (const auto& handle : m_battle_core.GetQueue())
+	{
+		const auto& unit_character_c = Cast<ACharacter>(GetUnitByHandle(handle));
+		if (unit_character_c)
+			eye_height = FMath::Max(eye_height, unit_character_c->GetCapsuleComponent()->GetScaledCapsuleHalfHeight());
+
+		max_distance = FMath::Max(max_distance, (float)m_battle_core.GetUnit(handle).attack_range);
+	}
+
+	m_line_of_sight_grid->Build(center, radius, eye_height, max_distance);
+}
+
+void UVEN_BattleInstance::UpdateNavMeshTilesStat(bool reset_snapshot)
+{
+	//stat follows the player battle only
+	if (!m_is_player_battle)
+		return;
+
+#if WITH_RECAST
+	const auto& navigation_system = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetGameMode()->GetWorld());
+	const auto& recast_nav_mesh = navigation_system ? Cast<ARecastNavMesh>(navigation_system->GetDefaultNavDataInstance(FNavigationSystem::DontCreate)) : nullptr;
+	const dtNavMesh* detour_nav_mesh = recast_nav_mesh ? recast_nav_mesh->GetRecastMesh() : nullptr;
+	if (!detour_nav_mesh)
+		return;
+
+	uint32 rebuilt_tiles_count = 0;
+	const int max_tiles = detour_nav_mesh->getMaxTiles();
+	m_nav_mesh_tiles_salt.SetNumZeroed(max_tiles);
+
+	for (int i = 0; i < max_tiles; ++i)
+	{
+		const dtMeshTile* tile = detour_nav_mesh->getTile(i);
+		const uint32 salt = tile && tile->header ? tile->salt : 0;
+		if (m_nav_mesh_tiles_salt[i] != salt)
+		{
+			rebuilt_tiles_count++;
+			m_nav_mesh_tiles_salt[i] = salt;
+		}
+	}
+
+	SET_DWORD_STAT(STAT_VEN_NavMeshTilesRebuiltPerTurn, reset_snapshot ? 0 : rebuilt_tiles_count);
+#endif
+}
+
+bool UVEN_BattleInstance::CanBattleBeFinished()
+{
+	return m_battle_core.CanBattleBeFinished();
+}
+
+void UVEN_BattleInstance::ResetAllTurnPoints()
+{
+	m_battle_core.ResetAllTurnPoints();
+
+	for (const auto& handle : m_battle_core.GetQueue())
+	{
+		const auto& participant = GetParticipantByHandle(handle);
+		if (participant)
+			participant->ResetTurnPoints();
+	}
+}
+
+void UVEN_BattleInstance::TeleportStragglerPlayerUnit()
+{
+	AVEN_PlayerUnit* player_unit_if_fight = m_player_units.Num() ? Cast<AVEN_PlayerUnit>(m_player_units[0]) : nullptr;
+	AVEN_PlayerUnit* player_unit_straggler = nullptr;
+
+	if (!player_unit_if_fight)
+		return;
+
+	const auto& game_mode = GetGameMode();
+	if (!game_mode)
+		return;
+
+	const auto all_player_units = game_mode->GetPlayerUnits();
+	for (const auto& player_unit : all_player_units)
+	{
+		if (player_unit != player_unit_if_fight && !m_battle_system->IsInBattle(player_unit))
+		{
+			player_unit_straggler = player_unit;
+			break;
+		}
+	}
+
+	if (!player_unit_straggler)
+		return;
+
+	const FTransform teleport_point = m_battle_system->GetFarthestTeleportPoint(player_unit_if_fight->GetActorLocation());
+
+	player_unit_straggler->SetActorLocation(teleport_point.GetLocation(), false, nullptr, ETeleportType::ResetPhysics);
+	player_unit_straggler->SetActorRotation(teleport_point.GetRotation());
+	game_mode->GetUnitsSpatialHash()->UpdateUnitLocation(player_unit_straggler);
+	AddUnitToBattle(player_unit_straggler);
+}
+
+void UVEN_BattleInstance::StartReplayRecording()
+{
+	m_replay.Reset();
+	m_replay_file_path.Empty();
+#if UE_BUILD_SHIPPING
+	return;
+#else
+	if (!CVAR_RECORD_BATTLES.GetValueOnGameThread())
+		return;
+
+	//units are written in handle order, replay adds them to its core the same way
+	TArray<FVEN_BattleReplayUnit> replay_units;
+	for (int32 handle = 0; handle < m_battle_units.Num(); ++handle)
+		replay_units.Add({ m_battle_units[handle]->GetName(), m_battle_core.GetUnit(handle), m_battle_units[handle]->GetActorLocation() });
+
+	m_replay.RecordStart(m_random_seed, replay_units);
+
+	const FString replays_directory = FPaths::ProjectSavedDir() / TEXT("BattleReplays");
+	IFileManager::Get().MakeDirectory(*replays_directory, true);
+	m_replay_file_path = replays_directory / FString::Printf(TEXT("%s_%d.venreplay"), *FDateTime::Now().ToString(), m_random_seed);
+	UE_LOG(LogVENBattle, Log, TEXT("%s is recorded into %s"), *GetName(), *m_replay_file_path);
+
+	FlushReplayRecording(false);
+#endif
+}
+
+void UVEN_BattleInstance::FlushReplayRecording(bool is_finished)
+{
+	if (!m_replay.IsRecording())
+		return;
+
+	m_replay.Flush(m_replay_file_path);
+	if (is_finished)
+		m_replay.Reset();
+}
\ No newline at end of file
@@ -0,0 +1,299 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "VEN_BattleReplay.h"
+
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Misc/FileHelper.h"
+#include "HAL/FileManager.h"
+
+using namespace vendetta;
+
+namespace
+{
+	constexpr const uint32 REPLAY_MAGIC = 0x524E4556;
+	constexpr const uint8 REPLAY_VERSION = 1;
+}
+
+FVEN_BattleReplay::FVEN_BattleReplay()
+	: m_flushed_size(0)
+	, m_seed(0)
+{
+
+}
+
+void FVEN_BattleReplay::Reset()
+{
+	m_data.Empty();
+	m_flushed_size = 0;
+	m_seed = 0;
+	m_units.Empty();
+	m_events.Empty();
+}
+
+bool FVEN_BattleReplay::IsRecording() const
+{
+	return m_data.Num() > 0;
+}
+
+void FVEN_BattleReplay::RecordStart(int32 seed, const TArray<FVEN_BattleReplayUnit>& units)
+{
+	Reset();
+	m_seed = seed;
+	m_units = units;
+
+	FMemoryWriter writer(m_data, true, true);
+	uint32 magic = REPLAY_MAGIC;
+	uint8 version = REPLAY_VERSION;
+	writer << magic;
+	writer << version;
+
+	WriteEvent(BATTLE_REPLAY_EVENT::START, [&units, seed](FArchive& archive)
+	{
+		WriteInt(archive, seed);
+		WriteInt(archive, units.Num());
+
+		for (const auto& unit : units)
+		{
+			auto name = unit.name;
+			auto record = unit.record;
+			uint8 faction = (uint8)record.faction;
+			uint8 is_dead = record.is_dead ? 1 : 0;
+
+			archive << name;
+			archive << faction;
+			WriteInt(archive, record.hp_current);
+			WriteInt(archive, record.hp_total);
+			WriteInt(archive, record.hp_on_defeat);
+			archive << record.turn_points_left;
+			archive << record.turn_points_total;
+			WriteInt(archive, record.attack_power_min);
+			WriteInt(archive, record.attack_power_max);
+			WriteInt(archive, record.attack_range);
+			archive << record.attack_price;
+			archive << is_dead;
+			WriteLocation(archive, unit.location);
+		}
+	});
+}
+
+void FVEN_BattleReplay::RecordMove(int32 unit, const FVector& start, const FVector& end)
+{
+	WriteEvent(BATTLE_REPLAY_EVENT::MOVE, [unit, &start, &end](FArchive& archive)
+	{
+		WriteInt(archive, unit);
+		WriteLocation(archive, start);
+		WriteLocation(archive, end);
+	});
+}
+
+void FVEN_BattleReplay::RecordAttack(int32 attacker, int32 defender, int damage)
+{
+	WriteEvent(BATTLE_REPLAY_EVENT::ATTACK, [attacker, defender, damage](FArchive& archive)
+	{
+		WriteInt(archive, attacker);
+		WriteInt(archive, defender);
+		WriteInt(archive, damage);
+	});
+}
+
+void FVEN_BattleReplay::RecordTurnEnd(int32 unit)
+{
+	WriteEvent(BATTLE_REPLAY_EVENT::TURN_END, [unit](FArchive& archive)
+	{
+		WriteInt(archive, unit);
+	});
+}
+
+void FVEN_BattleReplay::RecordDeath(int32 unit)
+{
+	WriteEvent(BATTLE_REPLAY_EVENT::DEATH, [unit](FArchive& archive)
+	{
+		WriteInt(archive, unit);
+	});
+}
+
+void FVEN_BattleReplay::RecordFinish(bool game_over)
+{
+	WriteEvent(BATTLE_REPLAY_EVENT::FINISH, [game_over](FArchive& archive)
+	{
+		uint8 game_over_value = game_over ? 1 : 0;
+		archive << game_over_value;
+	});
+}
+
+bool FVEN_BattleReplay::Flush(const FString& file_path)
+{
+	if (m_flushed_size >= m_data.Num())
+		return true;
+
+	const TArrayView<const uint8> unflushed_data(m_data.GetData() + m_flushed_size, m_data.Num() - m_flushed_size);
+	if (!FFileHelper::SaveArrayToFile(unflushed_data, *file_path, &IFileManager::Get(), FILEWRITE_Append))
+	{
+		//debug_log("FVEN_BattleReplay::Flush. Cannot write replay file", FColor::Red);
+		return false;
+	}
+
+	m_flushed_size = m_data.Num();
+	return true;
+}
+
+bool FVEN_BattleReplay::Load(const FString& file_path)
+{
+	TArray<uint8> data;
+	if (!FFileHelper::LoadFileToArray(data, *file_path))
+		return false;
+
+	return Parse(data);
+}
+
+bool FVEN_BattleReplay::Parse(const TArray<uint8>& data)
+{
+	Reset();
+
+	FMemoryReader reader(data, true);
+	uint32 magic = 0;
+	uint8 version = 0;
+	reader << magic;
+	reader << version;
+	if (reader.IsError() || magic != REPLAY_MAGIC || version != REPLAY_VERSION)
+		return false;
+
+	while (!reader.AtEnd() && !reader.IsError())
+	{
+		uint8 type = 0;
+		reader << type;
+
+		FVEN_BattleReplayEvent event;
+		event.type = (BATTLE_REPLAY_EVENT)type;
+
+		switch (event.type)
+		{
+			case BATTLE_REPLAY_EVENT::START:
+			{
+				m_seed = ReadInt(reader);
+				const int32 units_count = ReadInt(reader);
+				if (units_count < 0 || units_count > data.Num())
+					return false;
+
+				for (int32 i = 0; i < units_count; ++i)
+				{
+					FVEN_BattleReplayUnit unit;
+					uint8 faction = 0;
+					uint8 is_dead = 0;
+
+					reader << unit.name;
+					reader << faction;
+					unit.record.faction = (BATTLE_FACTION)faction;
+					unit.record.hp_current = ReadInt(reader);
+					unit.record.hp_total = ReadInt(reader);
+					unit.record.hp_on_defeat = ReadInt(reader);
+					reader << unit.record.turn_points_left;
+					reader << unit.record.turn_points_total;
+					unit.record.attack_power_min = ReadInt(reader);
+					unit.record.attack_power_max = ReadInt(reader);
+					unit.record.attack_range = ReadInt(reader);
+					reader << unit.record.attack_price;
+					reader << is_dead;
+					unit.record.is_dead = is_dead != 0;
+					unit.location = ReadLocation(reader);
+					m_units.Add(unit);
+				}
+			} break;
+			case BATTLE_REPLAY_EVENT::MOVE:
+			{
+				event.unit = ReadInt(reader);
+				event.start = ReadLocation(reader);
+				event.end = ReadLocation(reader);
+			} break;
+			case BATTLE_REPLAY_EVENT::ATTACK:
+			{
+				event.unit = ReadInt(reader);
+				event.target = ReadInt(reader);
+				event.damage = ReadInt(reader);
+			} break;
+			case BATTLE_REPLAY_EVENT::TURN_END:
+			case BATTLE_REPLAY_EVENT::DEATH:
+			{
+				event.unit = ReadInt(reader);
+			} break;
+			case BATTLE_REPLAY_EVENT::FINISH:
+			{
+				uint8 game_over = 0;
+				reader << game_over;
+				event.game_over = game_over != 0;
+			} break;
+			default: return false;
+		}
+
+		//handles out of range mean the file is broken, replay must not index by them
+		if ((event.unit != INDEX_NONE && !m_units.IsValidIndex(event.unit)) || (event.target != INDEX_NONE && !m_units.IsValidIndex(event.target)))
+			return false;
+
+		m_events.Add(event);
+	}
+
+	return !reader.IsError() && m_events.Num() && m_events[0].type == BATTLE_REPLAY_EVENT::START;
+}
+
+int32 FVEN_BattleReplay::GetSeed() const
+{
+	return m_seed;
+}
+
+int32 FVEN_BattleReplay::GetDataSize() const
+{
+	return m_data.Num();
+}
+
+const TArray<FVEN_BattleReplayUnit>& FVEN_BattleReplay::GetUnits() const
+{
+	return m_units;
+}
+
+const TArray<FVEN_BattleReplayEvent>& FVEN_BattleReplay::GetEvents() const
+{
+	return m_events;
+}
+
+void FVEN_BattleReplay::WriteInt(FArchive& archive, int32 value)
+{
+	//zigzag keeps small negative values (coordinates) short
+	uint32 zigzag = ((uint32)value << 1) ^ (uint32)(value >> 31);
+	archive.SerializeIntPacked(zigzag);
+}
+
+int32 FVEN_BattleReplay::ReadInt(FArchive& archive)
+{
+	uint32 zigzag = 0;
+	archive.SerializeIntPacked(zigzag);
+	return (int32)(zigzag >> 1) ^ -(int32)(zigzag & 1);
+}
+
+void FVEN_BattleReplay::WriteLocation(FArchive& archive, const FVector& location)
+{
+	WriteInt(archive, FMath::RoundToInt(location.X));
+	WriteInt(archive, FMath::RoundToInt(location.Y));
+	WriteInt(archive, FMath::RoundToInt(location.Z));
+}
+
+FVector FVEN_BattleReplay::ReadLocation(FArchive& archive)
+{
+	const int32 x = ReadInt(archive);
+	const int32 y = ReadInt(archive);
+	const int32 z = ReadInt(archive);
+	return FVector(x, y, z);
+}
+
+void FVEN_BattleReplay::WriteEvent(BATTLE_REPLAY_EVENT type, TFunctionRef<void(FArchive&)> write_payload)
+{
+	//nothing is written before the battle start
+	if (!IsRecording())
+		return;
+
+	FMemoryWriter writer(m_data, true, true);
+	uint8 type_value = (uint8)type;
+	writer << type_value;
+	write_payload(writer);
+}
\ No newline at end of file
@@ -0,0 +1,216 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "VEN_BattleReplayPlayer.h"
+#include "VEN_GameMode.h"
+#include "VEN_PlayerUnit.h"
+#include "VEN_EnemyUnit.h"
+#include "VEN_BattleParticipant.h"
+
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogVENBattleReplay, Log, All);
+
+using namespace vendetta;
+
+namespace
+{
+	//enough for hit and death animations to be noticed
+	constexpr const float DELAY_BETWEEN_EVENTS = 1.f;
+
+	void replay_battle_command(const TArray<FString>& args, UWorld* world)
+	{
+		const auto& game_mode = world ? Cast<AVEN_GameMode>(world->GetAuthGameMode()) : nullptr;
+		if (!game_mode || !game_mode->GetBattleSystem() || !args.Num())
+		{
+			UE_LOG(LogVENBattleReplay, Warning, TEXT("Usage: ven.ReplayBattle <file> [skipanimations]"));
+			return;
+		}
+
+		const bool skip_animations = args.Num() > 1 && args[1] == TEXT("skipanimations");
+		game_mode->GetBattleSystem()->StartReplay(args[0], skip_animations);
+	}
+
+	FAutoConsoleCommandWithWorldAndArgs REPLAY_BATTLE_COMMAND(
+		TEXT("ven.ReplayBattle"),
+		TEXT("Replays a recorded battle on level units: ven.ReplayBattle <file in Saved/BattleReplays or full path> [skipanimations]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&replay_battle_command));
+}
+
+UVEN_BattleReplayPlayer::UVEN_BattleReplayPlayer()
+	: m_next_event_index(0)
+	, m_skip_animations(false)
+	, m_in_progress(false)
+{
+
+}
+
+bool UVEN_BattleReplayPlayer::Start(const FString& file_path, bool skip_animations)
+{
+	Stop();
+
+	const FString full_file_path = FPaths::IsRelative(file_path) ? FPaths::ProjectSavedDir() / TEXT("BattleReplays") / file_path : file_path;
+	if (!m_replay.Load(full_file_path))
+	{
+		UE_LOG(LogVENBattleReplay, Warning, TEXT("Cannot load battle replay %s"), *full_file_path);
+		return false;
+	}
+
+	for (const auto& replay_unit : m_replay.GetUnits())
+	{
+		const auto& unit = FindUnit(replay_unit.name);
+		if (!unit)
+		{
+			UE_LOG(LogVENBattleReplay, Warning, TEXT("Battle replay unit %s is not found in the level"), *replay_unit.name);
+			Stop();
+			return false;
+		}
+
+		m_units.Add(unit);
+	}
+
+	//recorded state goes first, attacks then deal damage through the units' own handlers
+	for (int32 i = 0; i < m_units.Num(); ++i)
+	{
+		const auto& replay_unit = m_replay.GetUnits()[i];
+		const auto& participant = Cast<IVEN_BattleParticipant>(m_units[i]);
+		if (!participant->ApplyBattleUnitRecord(replay_unit.record))
+		{
+			UE_LOG(LogVENBattleReplay, Warning, TEXT("Battle replay unit %s cannot be restored to its recorded state, reload the level"), *replay_unit.name);
+			Stop();
+			return false;
+		}
+
+		TeleportUnit(m_units[i], replay_unit.location, replay_unit.location);
+	}
+
+	UE_LOG(LogVENBattleReplay, Log, TEXT("Replaying %s: %d units, %d events, seed %d"), *full_file_path, m_units.Num(), m_replay.GetEvents().Num(), m_replay.GetSeed());
+
+	m_next_event_index = 0;
+	m_skip_animations = skip_animations;
+	m_in_progress = true;
+	PlayNextEvents();
+	return true;
+}
+
+void UVEN_BattleReplayPlayer::Stop()
+{
+	if (GetWorld())
+		GetWorld()->GetTimerManager().ClearTimer(m_tmr_next_events);
+
+	m_in_progress = false;
+	m_units.Empty();
+	m_replay.Reset();
+	m_next_event_index = 0;
+}
+
+bool UVEN_BattleReplayPlayer::IsInProgress() const
+{
+	return m_in_progress;
+}
+
+void UVEN_BattleReplayPlayer::PlayNextEvents()
+{
+	const auto& events = m_replay.GetEvents();
+
+	while (m_in_progress && m_next_event_index < events.Num())
+	{
+		const bool takes_time = ApplyEvent(events[m_next_event_index++]);
+		if (takes_time && !m_skip_animations)
+		{
+			GetWorld()->GetTimerManager().SetTimer(m_tmr_next_events, this, &UVEN_BattleReplayPlayer::PlayNextEvents, DELAY_BETWEEN_EVENTS);
+			return;
+		}
+	}
+
+	Stop();
+}
+
+bool UVEN_BattleReplayPlayer::ApplyEvent(const FVEN_BattleReplayEvent& event)
+{
+	switch (event.type)
+	{
+		case BATTLE_REPLAY_EVENT::MOVE:
+		{
+			//path itself is not recorded, unit jumps to its end facing the way it went
+			TeleportUnit(m_units[event.unit], event.end, event.end + (event.end - event.start));
+			return true;
+		}
+		case BATTLE_REPLAY_EVENT::ATTACK:
+		{
+			const auto& attacker = m_units[event.unit];
+			const auto& defender = m_units[event.target];
+			TeleportUnit(attacker, attacker->GetActorLocation(), defender->GetActorLocation());
+
+			//units react to damage on their own: hit, stun and death animations
+			const auto& player_unit_defender_c = Cast<AVEN_PlayerUnit>(defender);
+			const auto& enemy_unit_defender_c = Cast<AVEN_EnemyUnit>(defender);
+			if (player_unit_defender_c)
+				player_unit_defender_c->OnReceiveDamage(event.damage, attacker);
+			else if (enemy_unit_defender_c)
+				enemy_unit_defender_c->OnReceiveDamage(event.damage, attacker);
+
+			return true;
+		}
+		case BATTLE_REPLAY_EVENT::DEATH:
+		{
+			const auto& participant = Cast<IVEN_BattleParticipant>(m_units[event.unit]);
+			if (participant && !participant->GetBattleUnitRecord().is_dead)
+			{
+				UE_LOG(LogVENBattleReplay, Warning, TEXT("Battle replay diverged: %s survived its recorded death"), *m_units[event.unit]->GetName());
+
+				//the rest of the replay expects the unit defeated
+				auto record = participant->GetBattleUnitRecord();
+				record.hp_current = record.hp_on_defeat;
+				record.is_dead = true;
+				participant->ApplyBattleUnitRecord(record);
+				return true;
+			}
+
+			return false;
+		}
+		case BATTLE_REPLAY_EVENT::FINISH:
+		{
+			UE_LOG(LogVENBattleReplay, Log, TEXT("Battle replay finished with %s"), event.game_over ? TEXT("defeat") : TEXT("victory"));
+			return false;
+		}
+		default: return false;
+	}
+}
+
+AActor* UVEN_BattleReplayPlayer::FindUnit(const FString& name) const
+{
+	for (TActorIterator<AActor> iterator(GetWorld()); iterator; ++iterator)
+	{
+		if (iterator->GetName() == name && Cast<IVEN_BattleParticipant>(*iterator))
+			return *iterator;
+	}
+
+	return nullptr;
+}
+
+void UVEN_BattleReplayPlayer::TeleportUnit(AActor* unit, const FVector& location, const FVector& look_at_location)
+{
+	unit->SetActorLocation(location, false, nullptr, ETeleportType::ResetPhysics);
+
+	const FVector direction = (look_at_location - location).GetSafeNormal2D();
+	if (!direction.IsNearlyZero())
+		unit->SetActorRotation(direction.Rotation());
+
+	const auto& game_mode = GetGameMode();
+	if (game_mode && game_mode->GetUnitsSpatialHash())
+		game_mode->GetUnitsSpatialHash()->UpdateUnitLocation(unit);
+}
+
+AVEN_GameMode* UVEN_BattleReplayPlayer::GetGameMode() const
+{
+	const auto& world = GetWorld();
+	const auto& game_mode = world ? Cast<AVEN_GameMode>(world->GetAuthGameMode()) : nullptr;
+	//if (!game_mode)
+		//debug_log("UVEN_BattleReplayPlayer::GetGameMode. Game Mode not found!", FColor::Red);
+
+	return game_mode;
+}
\ No newline at end of file
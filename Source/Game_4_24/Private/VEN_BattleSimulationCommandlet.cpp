@@ -0,0 +1,321 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "VEN_BattleSimulationCommandlet.h"
+
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Parse.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogVENBattleSimulation, Log, All);
+
+using namespace vendetta;
+
+namespace
+{
+	constexpr const int32 DEFAULT_BATTLES_COUNT = 10000;
+	constexpr const int32 DEFAULT_SEED = 1;
+	constexpr const int32 DEFAULT_MAX_TURNS = 200;
+	constexpr const int32 UNIT_DESCRIPTION_FIELDS_COUNT = 6;
+	constexpr const int32 DEFAULT_BENCHMARK_ITERATIONS = 100000;
+
+	//brother (melee) and sister (bow) against a mercenaries squad
+	const FString DEFAULT_PLAYER_UNITS = "100:1000:15:25:150:300,80:1000:10:20:1500:400";
+	const FString DEFAULT_ENEMY_UNITS = "60:800:8:14:150:300,60:800:8:14:150:300,120:900:12:22:150:350";
+
+	struct FSimulationStats
+	{
+		int32 battles = 0;
+		int32 player_wins = 0;
+		int32 enemy_wins = 0;
+		int32 unfinished = 0;
+		int64 player_win_turns = 0;
+		int64 enemy_win_turns = 0;
+	};
+}
+
+UVEN_BattleSimulationCommandlet::UVEN_BattleSimulationCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UVEN_BattleSimulationCommandlet::Main(const FString& Params)
+{
+	int32 battles_count = DEFAULT_BATTLES_COUNT;
+	int32 seed = DEFAULT_SEED;
+	int32 max_turns = DEFAULT_MAX_TURNS;
+	FString player_units_description = DEFAULT_PLAYER_UNITS;
+	FString enemy_units_description = DEFAULT_ENEMY_UNITS;
+	FString starter = "any";
+	int32 queue_benchmark_participants = 0;
+	int32 benchmark_iterations = DEFAULT_BENCHMARK_ITERATIONS;
+	FString replay_file_path;
+
+	FParse::Value(*Params, TEXT("battles="), battles_count);
+	FParse::Value(*Params, TEXT("seed="), seed);
+	FParse::Value(*Params, TEXT("maxturns="), max_turns);
+	FParse::Value(*Params, TEXT("players="), player_units_description, false);
+	FParse::Value(*Params, TEXT("enemies="), enemy_units_description, false);
+	FParse::Value(*Params, TEXT("starter="), starter);
+	FParse::Value(*Params, TEXT("queuebenchmark="), queue_benchmark_participants);
+	FParse::Value(*Params, TEXT("iterations="), benchmark_iterations);
+	FParse::Value(*Params, TEXT("replay="), replay_file_path);
+
+	if (!replay_file_path.IsEmpty())
+		return RunReplay(replay_file_path, FMath::Max(benchmark_iterations, 1)) ? 0 : 1;
+
+	if (queue_benchmark_participants > 0)
+	{
+		RunTurnQueueBenchmark(queue_benchmark_participants, FMath::Max(benchmark_iterations, 1), seed);
+		return 0;
+	}
+
+	TArray<FVEN_BattleUnitRecord> player_units;
+	TArray<FVEN_BattleUnitRecord> enemy_units;
+	if (!ParseUnits(player_units_description, BATTLE_FACTION::PLAYER, player_units) || !ParseUnits(enemy_units_description, BATTLE_FACTION::ENEMY, enemy_units))
+	{
+		UE_LOG(LogVENBattleSimulation, Error, TEXT("Invalid units description, expected hp:turn_points:attack_min:attack_max:attack_range:attack_price separated by commas"));
+		return 1;
+	}
+
+	if (battles_count <= 0)
+		return 0;
+
+	//battles are spread over chunks, every battle gets its own stream so results do not depend on threads count
+	const int32 chunks_count = FMath::Clamp(FPlatformMisc::NumberOfCoresIncludingHyperthreads(), 1, battles_count);
+	TArray<FSimulationStats> chunks_stats;
+	chunks_stats.SetNum(chunks_count);
+
+	const bool random_starter = starter != "player" && starter != "enemy";
+	const double start_time = FPlatformTime::Seconds();
+
+	ParallelFor(chunks_count, [&](int32 chunk_index)
+	{
+		auto& stats = chunks_stats[chunk_index];
+
+		for (int32 battle_index = chunk_index; battle_index < battles_count; battle_index += chunks_count)
+		{
+			FRandomStream random_stream(seed + battle_index);
+
+			const bool players_start = random_starter ? random_stream.FRand() < .5f : starter == "player";
+
+			FVEN_BattleCore battle_core;
+			for (const auto& unit : players_start ? player_units : enemy_units)
+				battle_core.AddUnit(unit);
+			for (const auto& unit : players_start ? enemy_units : player_units)
+				battle_core.AddUnit(unit);
+
+			const auto result = battle_core.Simulate(random_stream, max_turns);
+
+			stats.battles++;
+			if (!result.is_finished)
+			{
+				stats.unfinished++;
+			}
+			else if (result.winner == BATTLE_FACTION::PLAYER)
+			{
+				stats.player_wins++;
+				stats.player_win_turns += result.turns;
+			}
+			else
+			{
+				stats.enemy_wins++;
+				stats.enemy_win_turns += result.turns;
+			}
+		}
+	});
+
+	const double elapsed_time = FPlatformTime::Seconds() - start_time;
+
+	FSimulationStats total;
+	for (const auto& stats : chunks_stats)
+	{
+		total.battles += stats.battles;
+		total.player_wins += stats.player_wins;
+		total.enemy_wins += stats.enemy_wins;
+		total.unfinished += stats.unfinished;
+		total.player_win_turns += stats.player_win_turns;
+		total.enemy_win_turns += stats.enemy_win_turns;
+	}
+
+	UE_LOG(LogVENBattleSimulation, Display, TEXT("Simulated %d battles in %.3f s (%d threads, seed %d)"), total.battles, elapsed_time, chunks_count, seed);
+	UE_LOG(LogVENBattleSimulation, Display, TEXT("Player win rate: %.2f%%, avg turns to victory: %.2f"),
+		100.f * total.player_wins / total.battles, total.player_wins ? (float)total.player_win_turns / total.player_wins : 0.f);
+	UE_LOG(LogVENBattleSimulation, Display, TEXT("Enemy win rate: %.2f%%, avg turns to victory: %.2f"),
+		100.f * total.enemy_wins / total.battles, total.enemy_wins ? (float)total.enemy_win_turns / total.enemy_wins : 0.f);
+	UE_LOG(LogVENBattleSimulation, Display, TEXT("Unfinished after %d turns: %d"), max_turns, total.unfinished);
+
+	return 0;
+}
+
+bool UVEN_BattleSimulationCommandlet::ParseUnits(const FString& units_description, BATTLE_FACTION faction, TArray<FVEN_BattleUnitRecord>& units) const
+{
+	TArray<FString> units_strings;
+	units_description.ParseIntoArray(units_strings, TEXT(","));
+
+	for (const auto& unit_string : units_strings)
+	{
+		TArray<FString> fields;
+		unit_string.ParseIntoArray(fields, TEXT(":"));
+		if (fields.Num() != UNIT_DESCRIPTION_FIELDS_COUNT)
+			return false;
+
+		FVEN_BattleUnitRecord record;
+		record.faction = faction;
+		record.hp_total = FCString::Atoi(*fields[0]);
+		record.hp_current = record.hp_total;
+		record.hp_on_defeat = faction == BATTLE_FACTION::PLAYER ? 1 : 0;
+		record.turn_points_total = FCString::Atof(*fields[1]);
+		record.turn_points_left = record.turn_points_total;
+		record.attack_power_min = FCString::Atoi(*fields[2]);
+		record.attack_power_max = FCString::Atoi(*fields[3]);
+		record.attack_range = FCString::Atoi(*fields[4]);
+		record.attack_price = FCString::Atof(*fields[5]);
+		units.Add(record);
+	}
+
+	return units.Num() > 0;
+}
+
+void UVEN_BattleSimulationCommandlet::RunTurnQueueBenchmark(int32 participants_count, int32 iterations, int32 seed) const
+{
+	FRandomStream random_stream(seed);
+	TArray<int32> victims;
+	victims.SetNum(iterations);
+	for (auto& victim : victims)
+		victim = random_stream.RandRange(0, participants_count - 1);
+
+	//every iteration: one turn passes, random participant dies and joins back, round starter is looked up
+	FVEN_TurnQueue ring_queue;
+	ring_queue.Reset(participants_count);
+	for (int32 handle = 0; handle < participants_count; ++handle)
+		ring_queue.Add(handle);
+
+	int64 checksum = 0;
+	double start_time = FPlatformTime::Seconds();
+	for (const auto& victim : victims)
+	{
+		ring_queue.Advance();
+		ring_queue.Remove(victim);
+		ring_queue.Add(victim);
+		checksum += ring_queue.GetNext(ring_queue.GetHead());
+	}
+	const double ring_time = FPlatformTime::Seconds() - start_time;
+
+	//the same operations the battle queue did before
+	TArray<int32> array_queue;
+	array_queue.Reserve(participants_count);
+	for (int32 handle = 0; handle < participants_count; ++handle)
+		array_queue.Add(handle);
+
+	start_time = FPlatformTime::Seconds();
+	for (const auto& victim : victims)
+	{
+		const int32 current_owner = array_queue[0];
+		array_queue.RemoveAt(0);
+		array_queue.Add(current_owner);
+		array_queue.Remove(victim);
+		array_queue.Add(victim);
+		int32 head_index = INDEX_NONE;
+		array_queue.Find(array_queue[0], head_index);
+		checksum += array_queue[(head_index + 1) % array_queue.Num()];
+	}
+	const double array_time = FPlatformTime::Seconds() - start_time;
+
+	UE_LOG(LogVENBattleSimulation, Display, TEXT("Turn queue benchmark: %d participants, %d iterations (checksum %lld)"), participants_count, iterations, checksum);
+	UE_LOG(LogVENBattleSimulation, Display, TEXT("Ring queue: %.1f ns per iteration"), ring_time * 1.0e9 / iterations);
+	UE_LOG(LogVENBattleSimulation, Display, TEXT("Array queue: %.1f ns per iteration"), array_time * 1.0e9 / iterations);
+}
+
+bool UVEN_BattleSimulationCommandlet::RunReplay(const FString& file_path, int32 iterations) const
+{
+	const FString full_file_path = FPaths::IsRelative(file_path) ? FPaths::ProjectSavedDir() / TEXT("BattleReplays") / file_path : file_path;
+
+	TArray<uint8> data;
+	if (!FFileHelper::LoadFileToArray(data, *full_file_path))
+	{
+		UE_LOG(LogVENBattleSimulation, Error, TEXT("Cannot read battle replay %s"), *full_file_path);
+		return false;
+	}
+
+	FVEN_BattleReplay replay;
+	if (!replay.Parse(data))
+	{
+		UE_LOG(LogVENBattleSimulation, Error, TEXT("Battle replay %s is broken"), *full_file_path);
+		return false;
+	}
+
+	if (!ReplayBattle(replay))
+		return false;
+
+	//parsing is timed as well, replays are read from disk every time they are played
+	const double start_time = FPlatformTime::Seconds();
+	for (int32 i = 0; i < iterations; ++i)
+	{
+		replay.Parse(data);
+		ReplayBattle(replay);
+	}
+	const double elapsed_time = FPlatformTime::Seconds() - start_time;
+
+	UE_LOG(LogVENBattleSimulation, Display, TEXT("Replay %s: %d bytes, %d units, %d events, seed %d"),
+		*full_file_path, data.Num(), replay.GetUnits().Num(), replay.GetEvents().Num(), replay.GetSeed());
+	UE_LOG(LogVENBattleSimulation, Display, TEXT("Parsed and replayed %d times: %.1f ns per event"),
+		iterations, elapsed_time * 1.0e9 / ((double)iterations * replay.GetEvents().Num()));
+
+	return true;
+}
+
+bool UVEN_BattleSimulationCommandlet::ReplayBattle(const FVEN_BattleReplay& replay) const
+{
+	FVEN_BattleCore battle_core;
+	for (const auto& unit : replay.GetUnits())
+		battle_core.AddUnit(unit.record);
+
+	battle_core.Start();
+
+	const auto& events = replay.GetEvents();
+	for (int32 i = 0; i < events.Num(); ++i)
+	{
+		const auto& event = events[i];
+		bool matches = true;
+
+		switch (event.type)
+		{
+			case BATTLE_REPLAY_EVENT::ATTACK:
+			{
+				matches = battle_core.GetCurrentTurnOwner() == event.unit;
+				battle_core.Attack(event.unit, event.target, event.damage);
+			} break;
+			case BATTLE_REPLAY_EVENT::MOVE:
+			case BATTLE_REPLAY_EVENT::TURN_END:
+			{
+				matches = battle_core.GetCurrentTurnOwner() == event.unit;
+				if (event.type == BATTLE_REPLAY_EVENT::TURN_END)
+					battle_core.FinishCurrentTurn();
+			} break;
+			case BATTLE_REPLAY_EVENT::DEATH:
+			{
+				matches = battle_core.GetUnit(event.unit).is_dead;
+			} break;
+			case BATTLE_REPLAY_EVENT::FINISH:
+			{
+				matches = battle_core.CanBattleBeFinished() && battle_core.IsGameOver() == event.game_over;
+				battle_core.Finish();
+			} break;
+			default: break;
+		}
+
+		if (!matches)
+		{
+			UE_LOG(LogVENBattleSimulation, Error, TEXT("Battle replay diverged from battle rules at event %d"), i);
+			return false;
+		}
+	}
+
+	return true;
+}
\ No newline at end of file
@@ -60,6 +60,7 @@ AVEN_Camera::AVEN_Camera()
 	, m_zooming_is_enabled(true)
 	, m_camera_follow_mode(false)
 	, m_camera_custom_collision_test(false)
+	, m_camera_last_traced_location(FVector(MAX_flt))
 {
 	PrimaryActorTick.bCanEverTick = true;
 
@@ -202,6 +203,7 @@ void AVEN_Camera::OnCameraPointEndOverlapCollision(UPrimitiveComponent* Overlapp
 	{
 		m_camera_jump_over_mode = false;
 		m_camera_jump_over_impact_point = FVector::ZeroVector;
+		m_camera_last_traced_location = FVector(MAX_flt);
 	}
 }
 
@@ -367,6 +369,9 @@ void AVEN_Camera::CheckMouseOnScreenBorders()
 
 void AVEN_Camera::CheckCameraLineTrace()
 {
+	if (!m_camera_jump_over_mode && RootComponent->GetComponentLocation().Equals(m_camera_last_traced_location))
+		return;
+
 	FVector camera_offset = FVector::ZeroVector;
 
 	if (m_camera_jump_over_mode)
@@ -410,6 +415,7 @@ void AVEN_Camera::CheckCameraLineTrace()
 	}
 
 	RootComponent->MoveComponent(camera_offset, FRotator::ZeroRotator, true);
+	m_camera_last_traced_location = RootComponent->GetComponentLocation();
 }
 
 void AVEN_Camera::UpdateCameraFollowPosition()
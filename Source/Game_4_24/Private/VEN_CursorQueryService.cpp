@@ -0,0 +1,74 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "VEN_CursorQueryService.h"
+#include "VEN_PlayerUnit.h"
+#include "VEN_EnemyUnit.h"
+#include "VEN_InteractableItem.h"
+#include "VEN_InteractableNPC.h"
+#include "VEN_Stats.h"
+
+#include "GameFramework/PlayerController.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Cursor Traces"), STAT_VEN_CursorTraces, STATGROUP_Vendetta);
+
+using namespace vendetta;
+
+UVEN_CursorQueryService::UVEN_CursorQueryService()
+	: m_hovered_actor_type(CURSOR_TARGET::NONE)
+	, m_last_update_frame(0)
+{
+
+}
+
+void UVEN_CursorQueryService::Initialize()
+{
+	m_hit_result = FHitResult();
+	m_hovered_actor_type = CURSOR_TARGET::NONE;
+	m_last_update_frame = 0;
+}
+
+void UVEN_CursorQueryService::Update(APlayerController* controller)
+{
+	if (!controller || m_last_update_frame == GFrameCounter)
+		return;
+
+	INC_DWORD_STAT(STAT_VEN_CursorTraces);
+
+	m_last_update_frame = GFrameCounter;
+	m_hit_result = FHitResult();
+	controller->GetHitResultUnderCursor(ECollisionChannel::ECC_Visibility, false, m_hit_result);
+	m_hovered_actor_type = ClassifyActor(m_hit_result.GetActor());
+}
+
+const FHitResult& UVEN_CursorQueryService::GetHitResult() const
+{
+	return m_hit_result;
+}
+
+AActor* UVEN_CursorQueryService::GetHoveredActor() const
+{
+	return m_hit_result.GetActor();
+}
+
+CURSOR_TARGET UVEN_CursorQueryService::GetHoveredActorType() const
+{
+	return m_hovered_actor_type;
+}
+
+CURSOR_TARGET UVEN_CursorQueryService::ClassifyActor(const AActor* actor) const
+{
+	if (!actor)
+		return CURSOR_TARGET::NONE;
+
+	if (actor->IsA<AVEN_PlayerUnit>())
+		return CURSOR_TARGET::PLAYER_UNIT;
+	if (actor->IsA<AVEN_EnemyUnit>())
+		return CURSOR_TARGET::ENEMY_UNIT;
+	if (actor->IsA<AVEN_InteractableItem>())
+		return CURSOR_TARGET::INTERACTABLE_ITEM;
+	if (actor->IsA<AVEN_InteractableNPC>())
+		return CURSOR_TARGET::INTERACTABLE_NPC;
+
+	return CURSOR_TARGET::OTHER;
+}
\ No newline at end of file
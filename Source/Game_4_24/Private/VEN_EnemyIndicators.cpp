@@ -0,0 +1,205 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "VEN_EnemyIndicators.h"
+#include "VEN_EnemyIndicatorsOverlay.h"
+#include "VEN_GameMode.h"
+#include "VEN_EnemyUnit.h"
+#include "VEN_Stats.h"
+
+#include "Engine/World.h"
+#include "Engine/GameViewportClient.h"
+#include "Materials/MaterialInterface.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "UObject/ConstructorHelpers.h"
+
+DECLARE_CYCLE_STAT(TEXT("Enemy Indicators Update"), STAT_VEN_EnemyIndicatorsUpdate, STATGROUP_Vendetta);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemy Indicator Changes"), STAT_VEN_EnemyIndicatorChanges, STATGROUP_Vendetta);
+
+namespace
+{
+	//5% per step, rank fill does not need to be finer
+	constexpr const int32 PERCENT_STEPS = 20;
+	constexpr const int32 RANKS_COUNT = 2;
+	//above the head, capsule half height is added
+	constexpr const float INDICATOR_HEIGHT = 40.f;
+	const FVector2D INDICATOR_SIZE(48.f, 48.f);
+	//over hud widgets
+	constexpr const int32 OVERLAY_Z_ORDER = 10;
+
+	//same parameter rank widgets drive
+	const FName PERCENT_PARAMETER = "Percent";
+}
+
+UVEN_EnemyIndicators::UVEN_EnemyIndicators()
+	: m_common_rank_material(nullptr)
+	, m_leader_rank_material(nullptr)
+	, m_is_dirty(false)
+	, m_is_initialized(false)
+{
+	static ConstructorHelpers::FObjectFinder<UMaterialInterface> CommonRankMaterial(TEXT("MaterialInstanceConstant'/Game/Materials/EnemyUnitRank/MI_EnemyUnitRankCommon.MI_EnemyUnitRankCommon'"));
+	static ConstructorHelpers::FObjectFinder<UMaterialInterface> LeaderRankMaterial(TEXT("MaterialInstanceConstant'/Game/Materials/EnemyUnitRank/MI_EnemyUnitRankLeader.MI_EnemyUnitRankLeader'"));
+	m_common_rank_material = CommonRankMaterial.Object;
+	m_leader_rank_material = LeaderRankMaterial.Object;
+}
+
+void UVEN_EnemyIndicators::Initialize()
+{
+	Uninitialize();
+
+	m_step_materials.SetNumZeroed(RANKS_COUNT * (PERCENT_STEPS + 1));
+	m_step_brushes.SetNum(RANKS_COUNT * (PERCENT_STEPS + 1));
+
+	if (m_common_rank_material && m_leader_rank_material)
+		AddOverlay();
+	//else
+		//debug_log("UVEN_EnemyIndicators::Initialize. Rank materials not found", FColor::Red);
+
+	m_is_initialized = true;
+}
+
+void UVEN_EnemyIndicators::Uninitialize()
+{
+	m_is_initialized = false;
+	m_is_dirty = false;
+	RemoveOverlay();
+	m_enemy_units.Empty();
+	m_steps.Empty();
+	m_step_materials.Empty();
+	m_step_brushes.Empty();
+}
+
+bool UVEN_EnemyIndicators::IsOverlayActive() const
+{
+	return m_overlay.IsValid();
+}
+
+bool UVEN_EnemyIndicators::UpdateIndicator(AVEN_EnemyUnit* enemy_unit, bool show, float percent)
+{
+	if (!enemy_unit)
+		return false;
+
+	const int32 step = show ? FMath::RoundToInt(FMath::Clamp(percent, 0.f, 1.f) * PERCENT_STEPS) : INDEX_NONE;
+
+	int32 index = m_enemy_units.IndexOfByKey(enemy_unit);
+	if (index == INDEX_NONE)
+	{
+		index = m_enemy_units.Add(enemy_unit);
+		m_steps.Add(INDEX_NONE);
+	}
+
+	if (m_steps[index] == step)
+		return false;
+
+	m_steps[index] = step;
+	m_is_dirty = true;
+	INC_DWORD_STAT(STAT_VEN_EnemyIndicatorChanges);
+	return true;
+}
+
+void UVEN_EnemyIndicators::Tick(float DeltaTime)
+{
+	UpdateOverlay();
+}
+
+bool UVEN_EnemyIndicators::IsTickable() const
+{
+	return m_is_initialized && m_is_dirty;
+}
+
+TStatId UVEN_EnemyIndicators::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UVEN_EnemyIndicators, STATGROUP_Tickables);
+}
+
+AVEN_GameMode* UVEN_EnemyIndicators::GetGameMode() const
+{
+	const auto& world = GetWorld();
+	const auto& game_mode = world ? Cast<AVEN_GameMode>(world->GetAuthGameMode()) : nullptr;
+	//if (!game_mode)
+		//debug_log("UVEN_EnemyIndicators::GetGameMode. Game Mode not found!", FColor::Red);
+
+	return game_mode;
+}
+
+void UVEN_EnemyIndicators::AddOverlay()
+{
+	const auto& game_mode = GetGameMode();
+	const auto& game_viewport = GetWorld() ? GetWorld()->GetGameViewport() : nullptr;
+	if (!game_mode || !game_viewport)
+	{
+		//debug_log("UVEN_EnemyIndicators::AddOverlay. Game Viewport not found!", FColor::Red);
+		return;
+	}
+
+	m_overlay = SNew(SVEN_EnemyIndicatorsOverlay)
+		.PlayerController(game_mode->GetMainController())
+		.IndicatorSize(INDICATOR_SIZE);
+	game_viewport->AddViewportWidgetContent(m_overlay.ToSharedRef(), OVERLAY_Z_ORDER);
+}
+
+void UVEN_EnemyIndicators::RemoveOverlay()
+{
+	if (!m_overlay.IsValid())
+		return;
+
+	const auto& game_viewport = GetWorld() ? GetWorld()->GetGameViewport() : nullptr;
+	if (game_viewport)
+		game_viewport->RemoveViewportWidgetContent(m_overlay.ToSharedRef());
+
+	m_overlay.Reset();
+}
+
+void UVEN_EnemyIndicators::UpdateOverlay()
+{
+	SCOPE_CYCLE_COUNTER(STAT_VEN_EnemyIndicatorsUpdate);
+
+	m_is_dirty = false;
+	if (!m_overlay.IsValid())
+		return;
+
+	TArray<FVEN_EnemyIndicator> indicators;
+	for (int32 i = m_enemy_units.Num() - 1; i >= 0; --i)
+	{
+		const auto& enemy_unit = m_enemy_units[i];
+		if (!IsValid(enemy_unit))
+		{
+			m_enemy_units.RemoveAtSwap(i);
+			m_steps.RemoveAtSwap(i);
+			continue;
+		}
+
+		if (m_steps[i] == INDEX_NONE)
+			continue;
+
+		FVEN_EnemyIndicator indicator;
+		indicator.actor = enemy_unit;
+		indicator.height = enemy_unit->GetSimpleCollisionHalfHeight() + INDICATOR_HEIGHT;
+		indicator.brush = GetBrush(enemy_unit, m_steps[i]);
+		indicators.Add(indicator);
+	}
+
+	m_overlay->SetIndicators(MoveTemp(indicators));
+}
+
+const FSlateBrush* UVEN_EnemyIndicators::GetBrush(const AVEN_EnemyUnit* enemy_unit, int32 step)
+{
+	const bool is_leader = enemy_unit->GetUnitType() == EEnemyUnitType::MERCENARY_LEADER;
+	const int32 index = (is_leader ? 1 : 0) * (PERCENT_STEPS + 1) + step;
+	if (!m_step_brushes.IsValidIndex(index))
+		return nullptr;
+
+	if (!m_step_materials[index])
+	{
+		const auto& step_material = UMaterialInstanceDynamic::Create(is_leader ? m_leader_rank_material : m_common_rank_material, this);
+		if (!step_material)
+			return nullptr;
+
+		step_material->SetScalarParameterValue(PERCENT_PARAMETER, (float)step / PERCENT_STEPS);
+		m_step_materials[index] = step_material;
+		m_step_brushes[index].SetResourceObject(step_material);
+		m_step_brushes[index].ImageSize = INDICATOR_SIZE;
+	}
+
+	return &m_step_brushes[index];
+}
\ No newline at end of file
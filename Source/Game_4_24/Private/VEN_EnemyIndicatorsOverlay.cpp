@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "VEN_EnemyIndicatorsOverlay.h"
+#include "VEN_Stats.h"
+
+#include "GameFramework/Actor.h"
+#include "GameFramework/PlayerController.h"
+#include "Rendering/DrawElements.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Enemy Indicators Drawn"), STAT_VEN_EnemyIndicatorsDrawn, STATGROUP_Vendetta);
+
+void SVEN_EnemyIndicatorsOverlay::Construct(const FArguments& InArgs)
+{
+	m_player_controller = InArgs._PlayerController;
+	m_indicator_size = InArgs._IndicatorSize;
+}
+
+void SVEN_EnemyIndicatorsOverlay::SetIndicators(TArray<FVEN_EnemyIndicator>&& indicators)
+{
+	m_indicators = MoveTemp(indicators);
+}
+
+int32 SVEN_EnemyIndicatorsOverlay::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+	const auto& player_controller = m_player_controller.Get();
+	if (!player_controller)
+		return LayerId;
+
+	//projection gives viewport pixels, geometry is in dpi scaled units
+	const float inverse_scale = AllottedGeometry.Scale > 0.f ? 1.f / AllottedGeometry.Scale : 1.f;
+	const FVector2D local_size = AllottedGeometry.GetLocalSize();
+	int32 drawn_count = 0;
+
+	for (const auto& indicator : m_indicators)
+	{
+		const auto& actor = indicator.actor.Get();
+		if (!actor || actor->IsHidden() || !indicator.brush)
+			continue;
+
+		FVector2D screen_position;
+		if (!player_controller->ProjectWorldLocationToScreen(actor->GetActorLocation() + FVector(0.f, 0.f, indicator.height), screen_position))
+			continue;
+
+		//indicator stands on its anchor point
+		const FVector2D position = screen_position * inverse_scale - FVector2D(m_indicator_size.X * .5f, m_indicator_size.Y);
+		if (position.X + m_indicator_size.X < 0.f || position.Y + m_indicator_size.Y < 0.f || position.X > local_size.X || position.Y > local_size.Y)
+			continue;
+
+		//indicators sharing a brush end up in one batch
+		FSlateDrawElement::MakeBox(OutDrawElements, LayerId, AllottedGeometry.ToPaintGeometry(position, m_indicator_size), indicator.brush, ESlateDrawEffect::None, InWidgetStyle.GetColorAndOpacityTint());
+		drawn_count++;
+	}
+
+	SET_DWORD_STAT(STAT_VEN_EnemyIndicatorsDrawn, drawn_count);
+	return LayerId;
+}
+
+FVector2D SVEN_EnemyIndicatorsOverlay::ComputeDesiredSize(float LayoutScaleMultiplier) const
+{
+	//fills the viewport, nothing to ask for
+	return FVector2D::ZeroVector;
+}
\ No newline at end of file
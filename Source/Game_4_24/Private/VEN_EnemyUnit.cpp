@@ -4,28 +4,27 @@
 #include "VEN_EnemyUnit.h"
 #include "VEN_GameMode.h"
 #include "VEN_BattleSystem.h"
+#include "VEN_BattleCore.h"
+#include "VEN_AttackSlotPlanner.h"
 #include "VEN_QuestsManager.h"
 #include "VEN_PlayerUnit.h"
 #include "VEN_AnimInstance.h"
 #include "VEN_FreeFunctions.h"
+#include "VEN_Stats.h"
 
 #include "Engine/Engine.h"
 #include "UObject/ConstructorHelpers.h"
 #include "Components/SplineComponent.h"
 #include "Components/CapsuleComponent.h"
 #include "Components/DecalComponent.h"
-#include "Perception/PawnSensingComponent.h"
-#include "NavigationSystem.h"
-#include "NavigationPath.h"
+#include "GameFramework/Controller.h"
 
 namespace
 {
 	constexpr const float DISTANCE_TO_CLOSEST_POINT_ERROR = 30.f;
-	constexpr const float MIN_DISTANCE_BETWEEN_RESERVED_POINTS = 100.f;
 	constexpr const float TURN_POINTS_LEFT_ERROR = 10.f;
 	constexpr const float SENSING_ANGLE = 60.f;
 	constexpr const float SENSING_RADIUS = 3000.f;
-	constexpr const float SENSING_INTERVAL = .25f;
 	constexpr const float SENSING_MIN_DISTANCE_TIME = 1.f;
 	constexpr const float SENSING_MAX_DISTANCE_TIME = 3.f;
 	constexpr const float SENSING_COOLDOWN_TIME = 5.f;
@@ -34,6 +33,8 @@ namespace
 	const FString QUEST_ID_TAG_PREFIX = "quest_id_";
 }
 
+DECLARE_CYCLE_STAT(TEXT("Enemy Find Target"), STAT_VEN_EnemyFindTarget, STATGROUP_Vendetta);
+
 using namespace vendetta;
 
 AVEN_EnemyUnit::AVEN_EnemyUnit()
@@ -42,18 +43,22 @@ AVEN_EnemyUnit::AVEN_EnemyUnit()
 	, m_movement_spline_is_built(false)
 	, m_is_currently_moving(false)
 	, m_spline_comleted_movement_distance(0.f)
+	, m_target_search_in_progress(false)
+	, m_decision_is_pending(false)
+	, m_rank_widget_is_hidden(false)
 {
+	//tick is enabled only while sensing or moving, player units are looked for by perception manager
 	PrimaryActorTick.bCanEverTick = true;
-
-	m_sensing_component = CreateDefaultSubobject<UPawnSensingComponent>(TEXT("Enemy Unit sensing component"));
-	m_sensing_component->SetPeripheralVisionAngle(SENSING_ANGLE);
-	m_sensing_component->SightRadius = SENSING_RADIUS;
-	m_sensing_component->SensingInterval = SENSING_INTERVAL;
-	m_sensing_component->bOnlySensePlayers = false;
-	m_sensing_component->OnSeePawn.AddDynamic(this, &AVEN_EnemyUnit::OnSeePawn);
+	PrimaryActorTick.bStartWithTickEnabled = false;
 
 	m_decal = CreateDefaultSubobject<UDecalComponent>("ActiveUnitDecal");
 	m_decal->SetupAttachment(RootComponent);
+
+	//units never dirty navmesh, in battle they are avoided by path queries
+	GetCapsuleComponent()->SetCanEverAffectNavigation(false);
+
+	//update rate parameters exist only if enabled before registration, animation budget drives them
+	GetMesh()->bEnableUpdateRateOptimizations = true;
 }
 
 void AVEN_EnemyUnit::BeginPlay()
@@ -63,6 +68,15 @@ void AVEN_EnemyUnit::BeginPlay()
 
 }
 
+void AVEN_EnemyUnit::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	const auto& game_mode = GetGameMode();
+	if (game_mode && game_mode->GetUnitsSpatialHash())
+		game_mode->GetUnitsSpatialHash()->UnregisterUnit(this);
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void AVEN_EnemyUnit::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
@@ -78,8 +92,13 @@ void AVEN_EnemyUnit::Initialize()
 	InitBattleRelatedProperties();
 	SetupRelatedQuests();
 	m_decal->SetVisibility(false);
-	OnRankWidgetUpdate(true);
+	UpdateRankIndicator(true);
 	EnableSensing();
+	UpdateTickEnabled();
+	GetGameMode()->GetPerceptionManager()->RegisterEnemyUnit(this);
+	GetGameMode()->GetUnitsSpatialHash()->RegisterUnit(this);
+	GetGameMode()->GetSignificanceManager()->RegisterActor(this);
+	GetGameMode()->GetAnimationBudget()->RegisterCharacter(this);
 }
 
 USkeletalMeshComponent* AVEN_EnemyUnit::GetEnemyUnitMesh() const
@@ -98,7 +117,7 @@ void AVEN_EnemyUnit::RegisterAnimInstance(UVEN_AnimInstance* instance)
 void AVEN_EnemyUnit::OnAnimationUpdate(ANIMATION_NOTIFICATION notification)
 {
 	const auto& battle_system = GetBattleSystem();
-	if (!battle_system || !battle_system->IsBattleInProgress() || !battle_system->IsCurrentTurnOwner(this))
+	if (!battle_system || !battle_system->IsCurrentTurnOwner(this))
 		return;
 
 	if (notification == ANIMATION_NOTIFICATION::ATTACK_ANIMATION_UPDATED)
@@ -126,8 +145,9 @@ void AVEN_EnemyUnit::OnStartBattle()
 	m_sensing_is_active = false;
 	m_sensing_current_percent = 0.f;
 	EnableSensing(false);
+	UpdateTickEnabled();
 	AnimInstanceUpdate(ANIMATION_UPDATE::START_BATTLE);
-	OnRankWidgetUpdate(true, 1.f);
+	UpdateRankIndicator(true, 1.f);
 }
 
 void AVEN_EnemyUnit::OnFinishBattle()
@@ -136,6 +156,7 @@ void AVEN_EnemyUnit::OnFinishBattle()
 		return;
 
 	m_in_battle = false;
+	CancelTargetSearch();
 	EnableSensing(true);
 	AnimInstanceUpdate(ANIMATION_UPDATE::FINISH_BATTLE);
 }
@@ -150,6 +171,7 @@ void AVEN_EnemyUnit::OnStartBattleTurn()
 
 void AVEN_EnemyUnit::OnFinishBattleTurn()
 {
+	CancelTargetSearch();
 	m_current_target = nullptr;
 	m_decal->SetVisibility(false);
 	GetGameMode()->GetMainCamera()->SetCameraFollowMode(false);
@@ -198,7 +220,7 @@ void AVEN_EnemyUnit::OnReceiveDamage(float damage_received, AActor* damage_deale
 			player_unit_attacker->IncrementXP(REWARD_XP_FOR_DEATH);
 	}
 
-	GetBattleSystem()->UpdateBlueprintBattleQueue();
+	GetBattleSystem()->UpdateBlueprintBattleQueue(this);
 }
 
 EEnemyUnitType AVEN_EnemyUnit::GetUnitType() const
@@ -226,9 +248,9 @@ int AVEN_EnemyUnit::GetAttackPowerMax() const
 	return m_attack_power_max;
 }
 
-int AVEN_EnemyUnit::GetRandomAttackPower() const
+int AVEN_EnemyUnit::GetRandomAttackPower(FRandomStream& random_stream) const
 {
-	return FMath::RandRange(m_attack_power_min, m_attack_power_max);
+	return random_stream.RandRange(m_attack_power_min, m_attack_power_max);
 }
 
 int AVEN_EnemyUnit::GetAttackRange() const
@@ -264,7 +286,7 @@ void AVEN_EnemyUnit::UpdateTurnPoints(float update_on_value)
 		m_turn_points_left = 0.f;
 	}
 
-	GetBattleSystem()->UpdateBlueprintBattleQueue();
+	GetBattleSystem()->UpdateBlueprintBattleQueue(this);
 }
 
 void AVEN_EnemyUnit::ResetTurnPoints()
@@ -277,6 +299,59 @@ bool AVEN_EnemyUnit::IsDead() const
 	return m_is_dead;
 }
 
+BATTLE_FACTION AVEN_EnemyUnit::GetBattleFaction() const
+{
+	return BATTLE_FACTION::ENEMY;
+}
+
+FVEN_BattleUnitRecord AVEN_EnemyUnit::GetBattleUnitRecord() const
+{
+	FVEN_BattleUnitRecord record;
+	record.faction = GetBattleFaction();
+	record.hp_current = m_hp_current;
+	record.hp_total = m_hp_total;
+	record.hp_on_defeat = 0;
+	record.turn_points_left = m_turn_points_left;
+	record.turn_points_total = m_turn_points_total;
+	record.attack_power_min = m_attack_power_min;
+	record.attack_power_max = m_attack_power_max;
+	record.attack_range = m_attack_range;
+	record.attack_price = m_attack_price;
+	record.is_dead = m_is_dead;
+	return record;
+}
+
+bool AVEN_EnemyUnit::ApplyBattleUnitRecord(const FVEN_BattleUnitRecord& record)
+{
+	//dead enemies have no way back in the animation graph, level has to be reloaded
+	if (m_is_dead && !record.is_dead)
+		return false;
+
+	m_hp_current = FMath::Clamp(record.hp_current, 0, m_hp_total);
+	if (record.is_dead && !m_is_dead)
+	{
+		//no quest updates and rewards, the death already happened in the recorded session
+		m_is_dead = true;
+		CancelTargetSearch();
+		AnimInstanceAction(ANIMATION_ACTION::DIE);
+		SetActorEnableCollision(false);
+		OnMapIconUpdate(false);
+		UpdateRankIndicator(false);
+	}
+
+	GetBattleSystem()->UpdateBlueprintBattleQueue(this);
+	return true;
+}
+
+FBattleQueueUnitInfo AVEN_EnemyUnit::GetBattleQueueUnitInfo() const
+{
+	FBattleQueueUnitInfo info;
+	info.icon_type = m_unit_icon_type;
+	info.hp_percent = (float)GetHP() / (float)GetTotalHP();
+	info.tps_percent = GetTurnPointsLeft() / GetTurnPointsTotal();
+	return info;
+}
+
 TArray<vendetta::QUEST_ID> AVEN_EnemyUnit::GetRelatedQuestIds() const
 {
 	return m_related_quests_ids;
@@ -287,21 +362,69 @@ void AVEN_EnemyUnit::EnableSensing(bool enable)
 	m_sensing_is_enabled = enable;
 }
 
-void AVEN_EnemyUnit::OnSeePawn(APawn* other_pawn)
+bool AVEN_EnemyUnit::IsSensingEnabled() const
 {
-	if (!m_sensing_is_enabled || m_sensing_is_active || !GetBattleSystem() || !GetBattleSystem()->GetBattleAllowed())
+	return m_sensing_is_enabled;
+}
+
+bool AVEN_EnemyUnit::IsSensingActive() const
+{
+	return m_sensing_is_active;
+}
+
+AActor* AVEN_EnemyUnit::GetSensingTarget() const
+{
+	return m_sensing_is_active ? m_current_target : nullptr;
+}
+
+float AVEN_EnemyUnit::GetSensingRadius() const
+{
+	return SENSING_RADIUS;
+}
+
+bool AVEN_EnemyUnit::IsInSensingCone(const AActor* target) const
+{
+	if (!target)
+		return false;
+
+	FVector view_location;
+	FRotator view_rotation;
+	GetActorEyesViewPoint(view_location, view_rotation);
+
+	const FVector direction_to_target = target->GetActorLocation() - view_location;
+	if (direction_to_target.SizeSquared() > FMath::Square(SENSING_RADIUS))
+		return false;
+
+	return FVector::DotProduct(direction_to_target.GetSafeNormal(), view_rotation.Vector()) > FMath::Cos(FMath::DegreesToRadians(SENSING_ANGLE));
+}
+
+FVector AVEN_EnemyUnit::GetSensingViewPoint() const
+{
+	FVector view_location;
+	FRotator view_rotation;
+	GetActorEyesViewPoint(view_location, view_rotation);
+
+	return view_location;
+}
+
+void AVEN_EnemyUnit::OnPlayerUnitSensed(AVEN_PlayerUnit* player_unit)
+{
+	if (!m_sensing_is_enabled || m_sensing_is_active || !GetBattleSystem())
 		return;
 
-	const auto& sensed_player_unit = Cast<AVEN_PlayerUnit>(other_pawn);
-	if (!sensed_player_unit || sensed_player_unit->IsDead())
+	if (!player_unit || player_unit->IsDead() || !GetBattleSystem()->CanStartBattle(this, player_unit))
 		return;
 
-	if (m_sensing_component->CouldSeePawn(other_pawn) && m_sensing_component->HasLineOfSightTo(other_pawn))
-	{
-		m_sensing_is_active = true;
-		m_current_target = sensed_player_unit;
-		m_rotation_before_sensing = GetActorRotation();
-	}
+	m_sensing_is_active = true;
+	m_sensing_target_is_visible = true;
+	m_current_target = player_unit;
+	m_rotation_before_sensing = GetActorRotation();
+	UpdateTickEnabled();
+}
+
+void AVEN_EnemyUnit::OnSensingTargetVisibilityUpdate(bool is_visible)
+{
+	m_sensing_target_is_visible = is_visible;
 }
 
 AVEN_GameMode* AVEN_EnemyUnit::GetGameMode() const
@@ -354,8 +477,8 @@ void AVEN_EnemyUnit::BuildMovementSpline(const FVector& destination_point, float
 	FVector start_movement_point = GetCapsuleComponent()->GetComponentLocation();
 	start_movement_point.Z -= half_capsule_height;
 
-	UNavigationPath* movement_path = UNavigationSystemV1::FindPathToLocationSynchronously(GetWorld(), start_movement_point, destination_point, this);
-	m_movement_spline_is_built = (movement_path->PathPoints.Num() > 0);
+	TArray<FVector> path_points;
+	m_movement_spline_is_built = GetGameMode()->GetNavigationService()->FindPath(this, start_movement_point, destination_point, path_points);
 
 	if (!m_movement_spline_is_built)
 		return;
@@ -374,9 +497,9 @@ void AVEN_EnemyUnit::BuildMovementSpline(const FVector& destination_point, float
 	m_movement_spline_actor->SetActorLocation(start_movement_point);
 
 	//setup created spline with points
-	for (int i = 1; i < movement_path->PathPoints.Num(); ++i)
+	for (int i = 1; i < path_points.Num(); ++i)
 	{
-		m_movement_spline_component->AddSplinePoint(movement_path->PathPoints[i], ESplineCoordinateSpace::World);
+		m_movement_spline_component->AddSplinePoint(path_points[i], ESplineCoordinateSpace::World);
 		m_movement_spline_component->SetSplinePointType(i, ESplinePointType::CurveClamped);
 	}
 
@@ -427,37 +550,39 @@ void AVEN_EnemyUnit::StartMovement()
 		return;
 	}
 
+	m_movement_track.Build(m_movement_spline_component);
 	m_is_currently_moving = true;
+	UpdateTickEnabled();
+
+	GetBattleSystem()->RecordMovement(this, GetActorLocation(), m_movement_track.GetEndLocation());
 }
 
 void AVEN_EnemyUnit::ContinueMovement()
 {
-	if (!m_movement_spline_component)
+	if (!m_movement_spline_component || !m_movement_track.IsBuilt())
 	{
 		m_is_currently_moving = false;
-		//debug_log("AVEN_EnemyUnit::ContinueMovement. Spline component is missing", FColor::Red);
+		UpdateTickEnabled();
+		//debug_log("AVEN_EnemyUnit::ContinueMovement. Movement track is missing", FColor::Red);
 		GetBattleSystem()->FinishCurrentTurn(this);
 		return;
 	}
 
-	if (m_spline_comleted_movement_distance < m_movement_spline_component->GetSplineLength())
+	if (m_spline_comleted_movement_distance < m_movement_track.GetLength())
 	{
 		m_spline_comleted_movement_distance += GetVelocity().Size() * GetWorld()->GetDeltaSeconds();
 
 		AddMovementInput(GetActorForwardVector(), 1.0f, true);
 
-		FVector spline_location = m_movement_spline_component->GetLocationAtDistanceAlongSpline(m_spline_comleted_movement_distance, ESplineCoordinateSpace::World);
-		FRotator spline_rotation = m_movement_spline_component->GetRotationAtDistanceAlongSpline(m_spline_comleted_movement_distance, ESplineCoordinateSpace::World);
-
-		spline_location.Z = GetCapsuleComponent()->GetComponentLocation().Z;
-		spline_rotation.SetComponentForAxis(EAxis::X, 0.f);
-		spline_rotation.SetComponentForAxis(EAxis::Y, 0.f);
+		FVector track_location = m_movement_track.GetLocationAtDistance(m_spline_comleted_movement_distance);
+		track_location.Z = GetCapsuleComponent()->GetComponentLocation().Z;
 
-		SetActorLocation(spline_location);
+		SetActorLocation(track_location);
+		GetGameMode()->GetUnitsSpatialHash()->UpdateUnitLocation(this);
 
-		//do not set unit rotation at last spline point - it will always be equal 0.0f
-		if (m_spline_comleted_movement_distance < (m_movement_spline_component->GetSplineLength() - 10.f))
-			SetActorRotation(spline_rotation);
+		//keep heading on the last few centimeters, sampled yaw there is unreliable
+		if (m_spline_comleted_movement_distance < (m_movement_track.GetLength() - 10.f))
+			SetActorRotation(FRotator(0.f, m_movement_track.GetYawAtDistance(m_spline_comleted_movement_distance), 0.f));
 	}
 	else
 	{
@@ -468,10 +593,13 @@ void AVEN_EnemyUnit::ContinueMovement()
 
 void AVEN_EnemyUnit::FinishMovement()
 {
-	float spent_points_on_movement = -m_spline_comleted_movement_distance;
+	//distance of the last tick can exceed track length
+	float spent_points_on_movement = -FMath::Min(m_spline_comleted_movement_distance, m_movement_track.GetLength());
 	m_spline_comleted_movement_distance = 0.f;
 	m_is_currently_moving = false;
 	m_movement_spline_component = nullptr;
+	m_movement_track.Reset();
+	UpdateTickEnabled();
 
 	if (m_in_battle)
 	{
@@ -516,10 +644,14 @@ void AVEN_EnemyUnit::InitBattleRelatedProperties()
 	m_is_dead = false;
 	m_in_battle = false;
 	m_sensing_current_percent = 0.f;
+	m_sensing_is_active = false;
+	m_sensing_target_is_visible = false;
 	m_hp_current = m_hp_total;
 	m_turn_points_left = m_turn_points_total;
 	m_reserved_point = FVector::ZeroVector;
 	m_rotation_before_sensing = FRotator::ZeroRotator;
+	m_target_search_in_progress = false;
+	m_decision_is_pending = false;
 }
 
 void AVEN_EnemyUnit::AttackAnimationStart()
@@ -528,7 +660,9 @@ void AVEN_EnemyUnit::AttackAnimationStart()
 
 	ANIMATION_ACTION action;
 
-	int random_attack_animation = FMath::RandRange(1, 2);
+	//battle stream keeps replays in step, animation choice is rolled like damage
+	const auto& battle = GetBattleSystem() ? GetBattleSystem()->GetBattle(this) : nullptr;
+	int random_attack_animation = battle ? battle->GetRandomStream().RandRange(1, 2) : FMath::RandRange(1, 2);
 	if (random_attack_animation == 1)
 		action = ANIMATION_ACTION::ATTACK_1;
 	else
@@ -540,12 +674,12 @@ void AVEN_EnemyUnit::AttackAnimationStart()
 void AVEN_EnemyUnit::Die()
 {
 	m_is_dead = true;
+	CancelTargetSearch();
 	GetQuestsManager()->OnUpdate(QUESTS_MANAGER_UPDATE::ENEMY_UNIT_KILLED, m_related_quests_ids, this);
 	AnimInstanceAction(ANIMATION_ACTION::DIE);
 	SetActorEnableCollision(false);
-	GetCapsuleComponent()->SetCanEverAffectNavigation(false);
 	OnMapIconUpdate(false);
-	OnRankWidgetUpdate(false);
+	UpdateRankIndicator(false);
 }
 
 bool AVEN_EnemyUnit::IsEnoughPointsForAction(IN_BATTLE_UNIT_ACTION action)
@@ -565,148 +699,15 @@ bool AVEN_EnemyUnit::IsEnoughPointsForAction(IN_BATTLE_UNIT_ACTION action)
 	return false;
 }
 
-void AVEN_EnemyUnit::CalculateAttackPoints(TMap<AActor*, TArray<FVector>>& attack_points_by_player_unit)
+void AVEN_EnemyUnit::MakeDecision()
 {
-	const auto& player_units = GetBattleSystem()->GetPlayerUnitsInBattle();
-	TMap<AActor*, FTransform> player_units_transforms;
-
-	for (const auto& player_unit : player_units)
-	{
-		const auto& player_unit_c = Cast<AVEN_PlayerUnit>(player_unit);
-		if (player_unit_c->IsDead())
-			continue;
-
-		attack_points_by_player_unit.Add(player_unit);
-		player_units_transforms.Add(player_unit);
-		player_units_transforms[player_unit] = player_unit->GetTransform();
-	}
-
-	if (!player_units_transforms.Num())
-		return;
-
-	for (const auto& player_unit_transform : player_units_transforms)
+	//continue once attack slot is assigned (in OnAttackSlotAssigned())
+	if (m_target_search_in_progress)
 	{
-		const float DISTANCE_TO_POINTS = GetAttackRange();
-		const TArray<float> ANGLE_TO_POINTS = { 0.f, 90.f, 180.f, 270.f };
-
-		for (int32_t i = 0; i < ANGLE_TO_POINTS.Num(); ++i)
-		{
-			FVector distance = FVector(DISTANCE_TO_POINTS, 0, 0);
-			FVector point_offset = distance.RotateAngleAxis(ANGLE_TO_POINTS[i] + FRotator(player_unit_transform.Value.GetRotation()).Yaw, FVector(0, 0, 1));
-			FVector new_point_location = player_unit_transform.Value.GetLocation() + point_offset;
-			attack_points_by_player_unit[player_unit_transform.Key].Add(new_point_location);
-		}
-	}
-}
-
-void AVEN_EnemyUnit::GatherAllCalculatedPoints(TMap<AActor*, TArray<FVector>>& attack_points_by_player_unit, TArray<FVector>& all_points)
-{
-	if (!attack_points_by_player_unit.Num())
+		m_decision_is_pending = true;
 		return;
-
-	for (const auto& attack_point_by_player : attack_points_by_player_unit)
-	{
-		all_points.Append(attack_point_by_player.Value);
 	}
-}
-
-void AVEN_EnemyUnit::ValidateAttackPoints(TArray<FVector>& points)
-{
-	if (!points.Num())
-		return;
-
-	bool point_is_invalid = false;
-	TArray<FVector> invalid_points;
-	TArray<FVector> reserved_points = GetBattleSystem()->GetEnemyUnitReservedAttackPoints();
-	TArray<AActor*> in_battle_units = GetBattleSystem()->GetAllUnitsInBattle();
 
-	for (const auto& point : points)
-	{
-		//check if movement spline can be built to point
-		BuildMovementSpline(point);
-		if (!m_movement_spline_is_built)
-		{
-			point_is_invalid = true;
-		}
-		DestroyMovementSpline();
-
-		//check collision with already reserved points
-		for (const auto& reserved_point : reserved_points)
-		{
-			if (calculate_distance(point, reserved_point) <= MIN_DISTANCE_BETWEEN_RESERVED_POINTS)
-			{
-				point_is_invalid = true;
-				break;
-			}
-		}
-
-		//check collision with other units
-		for (const auto& in_battle_unit : in_battle_units)
-		{
-			if (Cast<AVEN_EnemyUnit>(in_battle_unit) == this)
-				continue;
-
-			if (calculate_distance(point, in_battle_unit->GetActorLocation()) <= MIN_DISTANCE_BETWEEN_RESERVED_POINTS)
-			{
-				point_is_invalid = true;
-				break;
-			}
-		}
-
-		if (point_is_invalid)
-			invalid_points.Add(point);
-
-		point_is_invalid = false;
-	}
-
-	//remove invalid points from origin array
-	for (const auto& invalid_point : invalid_points)
-	{
-		if (points.Contains(invalid_point))
-			points.Remove(invalid_point);
-		//else
-			//debug_log("AVEN_EnemyUnit::ValidateAttackPoints. Attempt to remove not existing point", FColor::Red);
-	}
-}
-
-void AVEN_EnemyUnit::SortAttackPoints(TArray<FVector>& points)
-{
-	if (!points.Num())
-		return;
-
-	for (int32_t i = 0; i < points.Num() - 1; i++)
-	{
-		for (int32_t j = 0; j < points.Num() - i - 1; j++)
-		{
-			if (calculate_distance(GetActorLocation(), points[j]) > calculate_distance(GetActorLocation(), points[j + 1]))
-			{
-				const auto& tmp = points[j];
-				points[j] = points[j + 1];
-				points[j + 1] = tmp;
-			}
-		}
-	}
-}
-
-FVector AVEN_EnemyUnit::GetClosestAttackPoint(TArray<FVector>& points) const
-{
-	return points.Num() ? points[0] : FVector::ZeroVector;
-}
-
-AActor* AVEN_EnemyUnit::GetAttackPointTarget(FVector point, TMap<AActor*, TArray<FVector>>& attack_points_by_player_unit) const
-{
-	for (const auto& attack_point_by_player : attack_points_by_player_unit)
-	{
-		if (attack_point_by_player.Value.Contains(point))
-			return attack_point_by_player.Key;
-	}
-
-	//debug_log("AVEN_EnemyUnit::GetAttackPointTarget. Cannot find attack point target", FColor::Red);
-	return nullptr;
-}
-
-void AVEN_EnemyUnit::MakeDecision()
-{
 	//player units are unreachable
 	if (m_reserved_point == FVector::ZeroVector || !m_current_target)
 	{
@@ -775,22 +776,6 @@ void AVEN_EnemyUnit::MakeDecision()
 	}
 }
 
-void AVEN_EnemyUnit::ReservePoint(FVector point)
-{
-	const auto& battle_system = GetBattleSystem();
-	if (!battle_system)
-	{
-		//debug_log("AVEN_EnemyUnit::ReservePoint. Battle System is nullptr", FColor::Red);
-		return;
-	}
-
-	if (point == FVector::ZeroVector)
-		return;
-
-	m_reserved_point = point;
-	battle_system->AddEnemyUnitReservedAttackPoint(m_reserved_point);
-}
-
 void AVEN_EnemyUnit::SensingPlayerUnit(float DeltaTime)
 {
 	if (!m_sensing_is_enabled || !m_current_target)
@@ -801,9 +786,9 @@ void AVEN_EnemyUnit::SensingPlayerUnit(float DeltaTime)
 
 	float update_percent_on_value = 0.f;
 	const float distance_to_target = calculate_distance(GetActorLocation(), m_current_target->GetActorLocation());
-	const auto& sensed_pawn = Cast<APawn>(m_current_target);
 
-	if (distance_to_target <= SENSING_RADIUS && sensed_pawn && m_sensing_component->CouldSeePawn(sensed_pawn) && m_sensing_component->HasLineOfSightTo(sensed_pawn))
+	//visibility is updated by perception manager
+	if (distance_to_target <= SENSING_RADIUS && m_sensing_target_is_visible)
 	{
 		const float estimated_time_to_attack = SENSING_MIN_DISTANCE_TIME + (SENSING_MAX_DISTANCE_TIME - SENSING_MIN_DISTANCE_TIME) * (distance_to_target / SENSING_RADIUS);
 		update_percent_on_value = (100.f / estimated_time_to_attack) * DeltaTime;
@@ -814,14 +799,15 @@ void AVEN_EnemyUnit::SensingPlayerUnit(float DeltaTime)
 	}
 
 	m_sensing_current_percent += update_percent_on_value;
-	OnRankWidgetUpdate(true, m_sensing_current_percent / 100);
+	UpdateRankIndicator(true, m_sensing_current_percent / 100);
 
 	if (m_sensing_current_percent >= 100.f)
 	{
 		m_sensing_current_percent = 100.f;
 		m_sensing_is_active = false;
+		UpdateTickEnabled();
 
-		if (GetBattleSystem()->GetBattleAllowed())
+		if (GetBattleSystem()->CanStartBattle(this, m_current_target))
 		{
 			GetBattleSystem()->StartBattle(this, m_current_target);
 			return;
@@ -831,10 +817,39 @@ void AVEN_EnemyUnit::SensingPlayerUnit(float DeltaTime)
 	{
 		m_sensing_current_percent = 0.f;
 		m_sensing_is_active = false;
+		UpdateTickEnabled();
 		SetActorRotation(m_rotation_before_sensing);
 	}
 }
 
+void AVEN_EnemyUnit::UpdateTickEnabled()
+{
+	SetActorTickEnabled(m_sensing_is_active || m_is_currently_moving);
+}
+
+void AVEN_EnemyUnit::UpdateRankIndicator(bool show, float percent)
+{
+	const auto& enemy_indicators = GetGameMode() ? GetGameMode()->GetEnemyIndicators() : nullptr;
+	if (!enemy_indicators)
+	{
+		OnRankWidgetUpdate(show, percent);
+		return;
+	}
+
+	//own rank widget is updated only on a quantised change, and stays hidden while overlay draws ranks
+	const bool is_changed = enemy_indicators->UpdateIndicator(this, show, percent);
+	if (enemy_indicators->IsOverlayActive())
+	{
+		if (!m_rank_widget_is_hidden)
+			OnRankWidgetUpdate(false);
+		m_rank_widget_is_hidden = true;
+	}
+	else if (is_changed)
+	{
+		OnRankWidgetUpdate(show, percent);
+	}
+}
+
 void AVEN_EnemyUnit::RotateToPlayerUnit()
 {
 	if (!m_current_target)
@@ -850,20 +865,44 @@ void AVEN_EnemyUnit::RotateToPlayerUnit()
 
 void AVEN_EnemyUnit::FindTarget()
 {
-	//find and gather attack points
-	TMap<AActor*, TArray<FVector>> attack_points_by_player_unit;
-	TArray<FVector> all_attack_points;
-	CalculateAttackPoints(attack_points_by_player_unit);
-	GatherAllCalculatedPoints(attack_points_by_player_unit, all_attack_points);
-	ValidateAttackPoints(all_attack_points);
-	SortAttackPoints(all_attack_points);
+	SCOPE_CYCLE_COUNTER(STAT_VEN_EnemyFindTarget);
 
-	//update reserved attack point
-	m_reserved_point = FVector::ZeroVector;
-	ReservePoint(GetClosestAttackPoint(all_attack_points));
+	const auto& battle = GetBattleSystem() ? GetBattleSystem()->GetBattle(this) : nullptr;
+	const auto& attack_slot_planner = battle ? battle->GetAttackSlotPlanner() : nullptr;
+	if (!attack_slot_planner)
+	{
+		//debug_log("AVEN_EnemyUnit::FindTarget. Attack Slot Planner not found!", FColor::Red);
+		return;
+	}
+
+	//slot may be already planned for this round, then callback is called immediately
+	m_target_search_in_progress = true;
+	attack_slot_planner->RequestAssignment(this, FVEN_OnAttackSlotAssigned::CreateUObject(this, &AVEN_EnemyUnit::OnAttackSlotAssigned));
+}
 
-	//update target
-	m_current_target = m_reserved_point == FVector::ZeroVector ? nullptr : GetAttackPointTarget(m_reserved_point, attack_points_by_player_unit);
+void AVEN_EnemyUnit::CancelTargetSearch()
+{
+	const auto& battle = GetBattleSystem() ? GetBattleSystem()->GetBattle(this) : nullptr;
+	if (m_target_search_in_progress && battle && battle->GetAttackSlotPlanner())
+		battle->GetAttackSlotPlanner()->CancelRequest(this);
+
+	m_target_search_in_progress = false;
+	m_decision_is_pending = false;
+}
+
+void AVEN_EnemyUnit::OnAttackSlotAssigned(const FVEN_AttackSlot& slot)
+{
+	m_target_search_in_progress = false;
+
+	//update reserved attack point and target
+	m_reserved_point = slot.point;
+	m_current_target = m_reserved_point == FVector::ZeroVector ? nullptr : slot.target;
+
+	if (m_decision_is_pending)
+	{
+		m_decision_is_pending = false;
+		MakeDecision();
+	}
 }
 
 DIRECTION AVEN_EnemyUnit::GetAttackDirection(FRotator attacker_rotation) const
@@ -66,6 +66,46 @@ UVEN_CursorManager* AVEN_GameMode::GetCursorManager() const
 	return m_cursor_manager;
 }
 
+UVEN_NavigationService* AVEN_GameMode::GetNavigationService() const
+{
+	return m_navigation_service;
+}
+
+UVEN_PerceptionManager* AVEN_GameMode::GetPerceptionManager() const
+{
+	return m_perception_manager;
+}
+
+UVEN_VisibilityService* AVEN_GameMode::GetVisibilityService() const
+{
+	return m_visibility_service;
+}
+
+UVEN_CursorQueryService* AVEN_GameMode::GetCursorQueryService() const
+{
+	return m_cursor_query_service;
+}
+
+UVEN_UnitsSpatialHash* AVEN_GameMode::GetUnitsSpatialHash() const
+{
+	return m_units_spatial_hash;
+}
+
+UVEN_SignificanceManager* AVEN_GameMode::GetSignificanceManager() const
+{
+	return m_significance_manager;
+}
+
+UVEN_AnimationBudget* AVEN_GameMode::GetAnimationBudget() const
+{
+	return m_animation_budget;
+}
+
+UVEN_EnemyIndicators* AVEN_GameMode::GetEnemyIndicators() const
+{
+	return m_enemy_indicators;
+}
+
 TArray<int> AVEN_GameMode::GetInventory() const
 {
 	return m_inventory;
@@ -148,6 +188,24 @@ void AVEN_GameMode::OnLevelPreUnload()
 
 	if (m_battle_system)
 		m_battle_system->Uninitialize();
+
+	if (m_perception_manager)
+		m_perception_manager->Uninitialize();
+
+	if (m_visibility_service)
+		m_visibility_service->Uninitialize();
+
+	if (m_units_spatial_hash)
+		m_units_spatial_hash->Uninitialize();
+
+	if (m_significance_manager)
+		m_significance_manager->Uninitialize();
+
+	if (m_animation_budget)
+		m_animation_budget->Uninitialize();
+
+	if (m_enemy_indicators)
+		m_enemy_indicators->Uninitialize();
 }
 
 ECurrentLevel AVEN_GameMode::GetCurrentLevel() const
@@ -193,6 +251,14 @@ void AVEN_GameMode::InitializeAll()
 	InitializeQuestsManager();
 	InitializeBattleSystem();
 	InitializeCursorManager();
+	InitializeCursorQueryService();
+	InitializeNavigationService();
+	InitializeVisibilityService();
+	InitializeUnitsSpatialHash();
+	InitializePerceptionManager();
+	InitializeSignificanceManager();
+	InitializeAnimationBudget();
+	InitializeEnemyIndicators();
 	InitializePlayerUnits();
 	InitializeEnemyUnits();
 	InitializeNPCUnits();
@@ -292,6 +358,86 @@ void AVEN_GameMode::InitializeCursorManager()
 		//debug_log("AVEN_GameMode::InitializeCursorManager. Cursor Manager is nullptr", FColor::Red);
 }
 
+void AVEN_GameMode::InitializeNavigationService()
+{
+	m_navigation_service = NewObject<UVEN_NavigationService>(this, UVEN_NavigationService::StaticClass(), FName("navigation_service"));
+
+	if (m_navigation_service)
+		m_navigation_service->Initialize();
+	//else
+		//debug_log("AVEN_GameMode::InitializeNavigationService. Navigation Service is nullptr", FColor::Red);
+}
+
+void AVEN_GameMode::InitializePerceptionManager()
+{
+	m_perception_manager = NewObject<UVEN_PerceptionManager>(this, UVEN_PerceptionManager::StaticClass(), FName("perception_manager"));
+
+	if (m_perception_manager)
+		m_perception_manager->Initialize();
+	//else
+		//debug_log("AVEN_GameMode::InitializePerceptionManager. Perception Manager is nullptr", FColor::Red);
+}
+
+void AVEN_GameMode::InitializeVisibilityService()
+{
+	m_visibility_service = NewObject<UVEN_VisibilityService>(this, UVEN_VisibilityService::StaticClass(), FName("visibility_service"));
+
+	if (m_visibility_service)
+		m_visibility_service->Initialize();
+	//else
+		//debug_log("AVEN_GameMode::InitializeVisibilityService. Visibility Service is nullptr", FColor::Red);
+}
+
+void AVEN_GameMode::InitializeCursorQueryService()
+{
+	m_cursor_query_service = NewObject<UVEN_CursorQueryService>(this, UVEN_CursorQueryService::StaticClass(), FName("cursor_query_service"));
+
+	if (m_cursor_query_service)
+		m_cursor_query_service->Initialize();
+	//else
+		//debug_log("AVEN_GameMode::InitializeCursorQueryService. Cursor Query Service is nullptr", FColor::Red);
+}
+
+void AVEN_GameMode::InitializeUnitsSpatialHash()
+{
+	m_units_spatial_hash = NewObject<UVEN_UnitsSpatialHash>(this, UVEN_UnitsSpatialHash::StaticClass(), FName("units_spatial_hash"));
+
+	if (m_units_spatial_hash)
+		m_units_spatial_hash->Initialize();
+	//else
+		//debug_log("AVEN_GameMode::InitializeUnitsSpatialHash. Units Spatial Hash is nullptr", FColor::Red);
+}
+
+void AVEN_GameMode::InitializeSignificanceManager()
+{
+	m_significance_manager = NewObject<UVEN_SignificanceManager>(this, UVEN_SignificanceManager::StaticClass(), FName("significance_manager"));
+
+	if (m_significance_manager)
+		m_significance_manager->Initialize();
+	//else
+		//debug_log("AVEN_GameMode::InitializeSignificanceManager. Significance Manager is nullptr", FColor::Red);
+}
+
+void AVEN_GameMode::InitializeAnimationBudget()
+{
+	m_animation_budget = NewObject<UVEN_AnimationBudget>(this, UVEN_AnimationBudget::StaticClass(), FName("animation_budget"));
+
+	if (m_animation_budget)
+		m_animation_budget->Initialize();
+	//else
+		//debug_log("AVEN_GameMode::InitializeAnimationBudget. Animation Budget is nullptr", FColor::Red);
+}
+
+void AVEN_GameMode::InitializeEnemyIndicators()
+{
+	m_enemy_indicators = NewObject<UVEN_EnemyIndicators>(this, UVEN_EnemyIndicators::StaticClass(), FName("enemy_indicators"));
+
+	if (m_enemy_indicators)
+		m_enemy_indicators->Initialize();
+	//else
+		//debug_log("AVEN_GameMode::InitializeEnemyIndicators. Enemy Indicators is nullptr", FColor::Red);
+}
+
 void AVEN_GameMode::GatherPlayerUnits()
 {
 	TArray<AActor*> found_actors;
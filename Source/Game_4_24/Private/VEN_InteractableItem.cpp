@@ -168,10 +168,10 @@ AVEN_GameMode* AVEN_InteractableItem::GetGameMode() const
 	return game_mode;
 }
 
-void AVEN_InteractableItem::ActivateParticleSystem()
+void AVEN_InteractableItem::ActivateParticleSystem(bool activate)
 {
 	if (m_particle_system)
-		m_particle_system->SetActive(true);
+		m_particle_system->SetActive(activate);
 	//else
 		//debug_log("AVEN_InteractableItem::ActivateParticleSystem. Particles are corrupted", FColor::Red);
 }
\ No newline at end of file
@@ -29,6 +29,7 @@ AVEN_InteractableNPC::AVEN_InteractableNPC()
 	, m_unique_id(-1)
 {
 	PrimaryActorTick.bCanEverTick = false;
+	GetMesh()->bEnableUpdateRateOptimizations = true;
 }
 
 void AVEN_InteractableNPC::BeginPlay()
@@ -38,6 +39,15 @@ void AVEN_InteractableNPC::BeginPlay()
 
 }
 
+void AVEN_InteractableNPC::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	const auto& game_mode = GetGameMode();
+	if (game_mode && game_mode->GetUnitsSpatialHash())
+		game_mode->GetUnitsSpatialHash()->UnregisterUnit(this);
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void AVEN_InteractableNPC::Initialize()
 {
 	if (!GetGameMode())
@@ -51,6 +61,18 @@ void AVEN_InteractableNPC::Initialize()
 	if (quest_manager)
 		GetGameMode()->GetQuestsManager()->RegisterNPC(this);
 
+	const auto& units_spatial_hash = GetGameMode()->GetUnitsSpatialHash();
+	if (units_spatial_hash)
+		units_spatial_hash->RegisterUnit(this);
+
+	const auto& significance_manager = GetGameMode()->GetSignificanceManager();
+	if (significance_manager)
+		significance_manager->RegisterActor(this);
+
+	const auto& animation_budget = GetGameMode()->GetAnimationBudget();
+	if (animation_budget)
+		animation_budget->RegisterCharacter(this);
+
 	const auto& main_camera = GetGameMode()->GetMainCamera();
 	if (main_camera)
 		OnRegisterMainCamera(main_camera->GetMainCameraComponent());
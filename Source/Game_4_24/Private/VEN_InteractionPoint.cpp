@@ -0,0 +1,196 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "VEN_InteractionPoint.h"
+#include "VEN_LineOfSightGrid.h"
+#include "VEN_Stats.h"
+
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Components/SplineComponent.h"
+#include "CollisionQueryParams.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Interaction Point Traces"), STAT_VEN_InteractionPointTraces, STATGROUP_Vendetta);
+
+namespace
+{
+	//coarse visibility probes inside of range are spread at most this far apart,
+	//visible stretches shorter than that can be missed
+	constexpr const float COARSE_PROBE_MAX_STEP = 200.f;
+	//bisection stops once hidden and visible probes are this close, found point is the visible one
+	constexpr const float BISECTION_MIN_STEP = 25.f;
+
+	struct FPathRange
+	{
+		float start_distance;
+		float end_distance;
+	};
+
+	FVector get_point_at_distance(const TArray<FVector>& path_points, const TArray<float>& distances, float distance)
+	{
+		for (int i = 1; i < path_points.Num(); ++i)
+		{
+			if (distance > distances[i] && i < path_points.Num() - 1)
+				continue;
+
+			const float segment_length = distances[i] - distances[i - 1];
+			const float alpha = segment_length > KINDA_SMALL_NUMBER ? FMath::Clamp((distance - distances[i - 1]) / segment_length, 0.f, 1.f) : 0.f;
+			return FMath::Lerp(path_points[i - 1], path_points[i], alpha);
+		}
+
+		return path_points.Last();
+	}
+
+	//parts of path which are inside the circle around target, in path order
+	void gather_ranges_in_radius(const TArray<FVector>& path_points, const TArray<float>& distances, const FVector& target_location, float radius, TArray<FPathRange>& ranges)
+	{
+		const FVector2D target(target_location);
+
+		for (int i = 1; i < path_points.Num(); ++i)
+		{
+			const FVector2D segment_start(path_points[i - 1]);
+			const FVector2D direction = FVector2D(path_points[i]) - segment_start;
+			const FVector2D to_start = segment_start - target;
+
+			//|to_start + t * direction|^2 = radius^2
+			const float a = direction.SizeSquared();
+			const float b = 2.f * FVector2D::DotProduct(direction, to_start);
+			const float c = to_start.SizeSquared() - radius * radius;
+
+			float t_enter = 0.f;
+			float t_exit = 1.f;
+
+			if (a < KINDA_SMALL_NUMBER)
+			{
+				if (c > 0.f)
+					continue;
+			}
+			else
+			{
+				const float discriminant = b * b - 4.f * a * c;
+				if (discriminant < 0.f)
+					continue;
+
+				const float discriminant_root = FMath::Sqrt(discriminant);
+				t_enter = FMath::Max((-b - discriminant_root) / (2.f * a), 0.f);
+				t_exit = FMath::Min((-b + discriminant_root) / (2.f * a), 1.f);
+
+				if (t_enter > t_exit)
+					continue;
+			}
+
+			const float segment_length = distances[i] - distances[i - 1];
+			const FPathRange range = { distances[i - 1] + t_enter * segment_length, distances[i - 1] + t_exit * segment_length };
+
+			//path stays inside the circle across segments
+			if (ranges.Num() && FMath::IsNearlyEqual(ranges.Last().end_distance, range.start_distance, 1.f))
+				ranges.Last().end_distance = range.end_distance;
+			else
+				ranges.Add(range);
+		}
+	}
+}
+
+namespace vendetta
+{
+	bool find_interaction_location(const TArray<FVector>& path_points, const FVector& target_location, float interaction_radius, TFunctionRef<bool(const FVector&)> is_target_visible, FVector& interaction_location)
+	{
+		if (path_points.Num() < 2)
+			return false;
+
+		TArray<float> distances;
+		distances.Reserve(path_points.Num());
+		distances.Add(0.f);
+		for (int i = 1; i < path_points.Num(); ++i)
+			distances.Add(distances[i - 1] + FVector::Dist(path_points[i - 1], path_points[i]));
+
+		TArray<FPathRange> ranges;
+		gather_ranges_in_radius(path_points, distances, target_location, interaction_radius, ranges);
+
+		//coarse probes are spread evenly over every range, its start and end included
+		for (const auto& range : ranges)
+		{
+			const float range_length = range.end_distance - range.start_distance;
+			const int32 probes_count = FMath::Max(1, FMath::CeilToInt(range_length / COARSE_PROBE_MAX_STEP));
+			const float probe_step = range_length / probes_count;
+
+			for (int32 probe = 0; probe <= probes_count; ++probe)
+			{
+				float visible_distance = range.start_distance + probe_step * probe;
+				FVector visible_location = get_point_at_distance(path_points, distances, visible_distance);
+				if (!is_target_visible(visible_location))
+					continue;
+
+				//range start is visible already
+				if (!probe)
+				{
+					interaction_location = visible_location;
+					return true;
+				}
+
+				//target shows up between previous hidden probe and this one
+				float hidden_distance = visible_distance - probe_step;
+				while (visible_distance - hidden_distance > BISECTION_MIN_STEP)
+				{
+					const float middle_distance = (hidden_distance + visible_distance) * .5f;
+					const FVector middle_location = get_point_at_distance(path_points, distances, middle_distance);
+					if (is_target_visible(middle_location))
+					{
+						visible_distance = middle_distance;
+						visible_location = middle_location;
+					}
+					else
+					{
+						hidden_distance = middle_distance;
+					}
+				}
+
+				interaction_location = visible_location;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	FVector find_interaction_point(const USplineComponent* path_spline, const AActor* interacting_actor, const AActor* target_actor, float interaction_radius, float height_offset, const UVEN_LineOfSightGrid* line_of_sight_grid)
+	{
+		if (!path_spline || !target_actor || path_spline->GetNumberOfSplinePoints() < 2)
+			return FVector::ZeroVector;
+
+		const UWorld* world = path_spline->GetWorld();
+		if (!world)
+			return FVector::ZeroVector;
+
+		TArray<FVector> path_points;
+		path_points.Reserve(path_spline->GetNumberOfSplinePoints());
+		for (int i = 0; i < path_spline->GetNumberOfSplinePoints(); ++i)
+			path_points.Add(path_spline->GetLocationAtSplinePoint(i, ESplineCoordinateSpace::World));
+
+		const FVector target_location = target_actor->GetActorLocation();
+		const FVector height = FVector(0.f, 0.f, height_offset);
+
+		FCollisionQueryParams trace_params;
+		trace_params.AddIgnoredActor(interacting_actor);
+
+		//trace has to stop exactly at target
+		const auto is_target_visible = [&](const FVector& path_location)
+		{
+			const FVector checkpoint_location = path_location + height;
+
+			if (line_of_sight_grid && line_of_sight_grid->IsLineOfSightBlocked(checkpoint_location, target_location))
+				return false;
+
+			INC_DWORD_STAT(STAT_VEN_InteractionPointTraces);
+
+			FHitResult trace_hit_result;
+			return world->LineTraceSingleByChannel(trace_hit_result, checkpoint_location, target_location, ECC_Visibility, trace_params) && trace_hit_result.GetActor() == target_actor;
+		};
+
+		FVector interaction_location;
+		if (!find_interaction_location(path_points, target_location, interaction_radius, is_target_visible, interaction_location))
+			return FVector::ZeroVector;
+
+		return interaction_location + height;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "VEN_InteractionPoint.h"
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	//former search: checkpoints every 50 uu along the whole path, the first one in range and visible wins
+	constexpr const float REFERENCE_STEP = 50.f;
+	//the bisected point is within 25 uu after the hidden to visible change, the former checkpoint within 50 uu
+	constexpr const float TOLERANCE = REFERENCE_STEP;
+
+	bool find_reference_location(const TArray<FVector>& path_points, const FVector& target_location, float interaction_radius, TFunctionRef<bool(const FVector&)> is_target_visible, FVector& interaction_location)
+	{
+		float path_length = 0.f;
+		for (int i = 1; i < path_points.Num(); ++i)
+			path_length += FVector::Dist(path_points[i - 1], path_points[i]);
+
+		const int checkpoints_count = (int)(path_length / REFERENCE_STEP);
+		for (int i = 0; i < checkpoints_count; ++i)
+		{
+			float distance = (path_length / checkpoints_count) * i;
+			FVector checkpoint_location = path_points.Last();
+			for (int j = 1; j < path_points.Num(); ++j)
+			{
+				const float segment_length = FVector::Dist(path_points[j - 1], path_points[j]);
+				if (distance <= segment_length)
+				{
+					checkpoint_location = FMath::Lerp(path_points[j - 1], path_points[j], segment_length > 0.f ? distance / segment_length : 0.f);
+					break;
+				}
+				distance -= segment_length;
+			}
+
+			if (FVector::Dist2D(checkpoint_location, target_location) > interaction_radius)
+				continue;
+
+			if (is_target_visible(checkpoint_location))
+			{
+				interaction_location = checkpoint_location;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	struct FInteractionPointCase
+	{
+		const TCHAR* name;
+		FBox occluder;
+		bool is_expected_to_be_found;
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVEN_InteractionPointTest, "Vendetta.InteractionPoint.MatchesSteppedSearch", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FVEN_InteractionPointTest::RunTest(const FString& Parameters)
+{
+	//path turns left in front of target, the part inside of range starts on the first segment
+	const TArray<FVector> path_points = { FVector(0.f, 0.f, 0.f), FVector(1000.f, 0.f, 0.f), FVector(1000.f, 1000.f, 0.f) };
+	const FVector target_location(1300.f, 500.f, 0.f);
+	const float interaction_radius = 600.f;
+
+	const FInteractionPointCase cases[] =
+	{
+		{ TEXT("open"), FBox(FVector(5000.f, 5000.f, -100.f), FVector(5100.f, 5100.f, 100.f)), true },
+		//hides the start of range, target shows up a third of the way along the second segment
+		{ TEXT("partially occluded"), FBox(FVector(1100.f, -200.f, -100.f), FVector(1150.f, 350.f, 100.f)), true },
+		{ TEXT("fully occluded"), FBox(FVector(1100.f, -2000.f, -100.f), FVector(1150.f, 2000.f, 100.f)), false }
+	};
+
+	for (const auto& test_case : cases)
+	{
+		int32 traces_count = 0;
+		const auto is_target_visible = [&test_case, &target_location, &traces_count](const FVector& location)
+		{
+			traces_count++;
+			return !FMath::LineBoxIntersection(test_case.occluder, location, target_location, target_location - location);
+		};
+
+		FVector location = FVector::ZeroVector;
+		FVector reference_location = FVector::ZeroVector;
+		const bool is_found = vendetta::find_interaction_location(path_points, target_location, interaction_radius, is_target_visible, location);
+		const int32 search_traces_count = traces_count;
+		traces_count = 0;
+		const bool is_reference_found = find_reference_location(path_points, target_location, interaction_radius, is_target_visible, reference_location);
+		const int32 reference_traces_count = traces_count;
+
+		TestEqual(FString::Printf(TEXT("%s: found"), test_case.name), is_found, test_case.is_expected_to_be_found);
+		TestEqual(FString::Printf(TEXT("%s: found as stepped search"), test_case.name), is_found, is_reference_found);
+		TestTrue(FString::Printf(TEXT("%s: fewer traces than stepped search (%d vs %d)"), test_case.name, search_traces_count, reference_traces_count), search_traces_count <= reference_traces_count);
+		if (!is_found || !is_reference_found)
+			continue;
+
+		TestTrue(FString::Printf(TEXT("%s: in range"), test_case.name), FVector::Dist2D(location, target_location) <= interaction_radius + KINDA_SMALL_NUMBER);
+		TestTrue(FString::Printf(TEXT("%s: visible"), test_case.name), is_target_visible(location));
+		TestTrue(FString::Printf(TEXT("%s: within tolerance of stepped search"), test_case.name), FVector::Dist(location, reference_location) <= TOLERANCE + 1.f);
+	}
+
+	return true;
+}
+
+#endif
\ No newline at end of file
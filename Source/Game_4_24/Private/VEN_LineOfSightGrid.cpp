@@ -0,0 +1,244 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "VEN_LineOfSightGrid.h"
+#include "VEN_BattleInstance.h"
+#include "VEN_Stats.h"
+
+#include "Engine/World.h"
+#include "CollisionQueryParams.h"
+#include "Async/ParallelFor.h"
+
+DECLARE_CYCLE_STAT(TEXT("Build Line Of Sight Grid"), STAT_VEN_BuildLineOfSightGrid, STATGROUP_Vendetta);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Line Of Sight Grid Cells"), STAT_VEN_LineOfSightGridCells, STATGROUP_Vendetta);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Line Of Sight Grid Rows Left"), STAT_VEN_LineOfSightGridRowsLeft, STATGROUP_Vendetta);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Line Of Sight Grid Pairs Traced"), STAT_VEN_LineOfSightGridPairsTraced, STATGROUP_Vendetta);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Line Of Sight Grid Blocked Answers"), STAT_VEN_LineOfSightGridBlockedAnswers, STATGROUP_Vendetta);
+
+using namespace vendetta;
+
+namespace
+{
+	constexpr const float CELL_SIZE = 150.f;
+	//ground is searched this far above and below the battle center
+	constexpr const float GROUND_SEARCH_HEIGHT = 1000.f;
+	//query point has to be about at eye height of its cell, otherwise it is not covered (bridges, stairs)
+	constexpr const float EYE_HEIGHT_TOLERANCE = 100.f;
+	//rows are traced in parallel, a frame takes rows until this many pairs are covered
+	constexpr const int32 MAX_TRACES_PER_FRAME = 4096;
+}
+
+UVEN_LineOfSightGrid::UVEN_LineOfSightGrid()
+	: m_battle(nullptr)
+	, m_origin(FVector::ZeroVector)
+	, m_cells_per_side(0)
+	, m_traced_rows_count(0)
+	, m_max_distance(0.f)
+{
+
+}
+
+void UVEN_LineOfSightGrid::Initialize(UVEN_BattleInstance* battle)
+{
+	m_battle = battle;
+	Reset();
+}
+
+void UVEN_LineOfSightGrid::Reset()
+{
+	m_cells_per_side = 0;
+	m_eye_points.Empty();
+	m_cells_indices.Empty();
+	m_rows.Empty();
+	m_traced_rows_count = 0;
+	m_trace_params = FCollisionQueryParams::DefaultQueryParam;
+	SET_DWORD_STAT(STAT_VEN_LineOfSightGridCells, 0);
+	SET_DWORD_STAT(STAT_VEN_LineOfSightGridRowsLeft, 0);
+}
+
+void UVEN_LineOfSightGrid::Build(const FVector& center, float radius, float eye_height, float max_distance)
+{
+	SCOPE_CYCLE_COUNTER(STAT_VEN_BuildLineOfSightGrid);
+
+	Reset();
+
+	const UWorld* world = m_battle ? m_battle->GetWorld() : nullptr;
+	if (!world || radius <= 0.f)
+		return;
+
+	m_origin = FVector(center.X - radius, center.Y - radius, center.Z);
+	m_cells_per_side = FMath::CeilToInt(radius * 2.f / CELL_SIZE);
+	m_max_distance = max_distance;
+
+	//ground is static geometry, sight is traced on the channel of callers without battle units,
+	//they move and are left to the real trace
+	const FCollisionObjectQueryParams static_objects(ECC_WorldStatic);
+	const FCollisionQueryParams trace_params;
+	m_trace_params.AddIgnoredActors(m_battle->GetBattleUnits());
+
+	//ground under every cell of the battle circle
+	TArray<FVector> cells_centers;
+	for (int32 y = 0; y < m_cells_per_side; ++y)
+	{
+		for (int32 x = 0; x < m_cells_per_side; ++x)
+		{
+			const FVector cell_center = m_origin + FVector((x + .5f) * CELL_SIZE, (y + .5f) * CELL_SIZE, 0.f);
+			if (FVector::DistSquared2D(cell_center, center) <= radius * radius)
+				cells_centers.Add(cell_center);
+		}
+	}
+
+	TArray<FVector> ground_points;
+	TArray<bool> ground_is_found;
+	ground_points.SetNum(cells_centers.Num());
+	ground_is_found.SetNumZeroed(cells_centers.Num());
+
+	ParallelFor(cells_centers.Num(), [&](int32 i)
+	{
+		FHitResult hit_result;
+		const FVector start = cells_centers[i] + FVector(0.f, 0.f, GROUND_SEARCH_HEIGHT);
+		const FVector end = cells_centers[i] - FVector(0.f, 0.f, GROUND_SEARCH_HEIGHT);
+		ground_is_found[i] = world->LineTraceSingleByObjectType(hit_result, start, end, static_objects, trace_params);
+		ground_points[i] = hit_result.ImpactPoint;
+	});
+
+	m_cells_indices.Init(INDEX_NONE, m_cells_per_side * m_cells_per_side);
+	for (int32 i = 0; i < cells_centers.Num(); ++i)
+	{
+		if (!ground_is_found[i])
+			continue;
+
+		m_cells_indices[GetGridIndex(cells_centers[i])] = m_eye_points.Num();
+		m_eye_points.Add(ground_points[i] + FVector(0.f, 0.f, eye_height));
+	}
+
+	//rows are traced by Tick
+	const int32 cells_count = m_eye_points.Num();
+	m_rows.SetNum(cells_count);
+
+	SET_DWORD_STAT(STAT_VEN_LineOfSightGridCells, cells_count);
+	SET_DWORD_STAT(STAT_VEN_LineOfSightGridRowsLeft, cells_count);
+}
+
+bool UVEN_LineOfSightGrid::IsValid() const
+{
+	return m_rows.Num() > 0;
+}
+
+bool UVEN_LineOfSightGrid::IsLineOfSightBlocked(const FVector& start, const FVector& end) const
+{
+	if (!IsValid())
+		return false;
+
+	//points are snapped to cell eye points, so every pair around them has to agree
+	TArray<int32, TInlineAllocator<4>> start_cells;
+	TArray<int32, TInlineAllocator<4>> end_cells;
+	if (!GatherNearbyCells(start, start_cells) || !GatherNearbyCells(end, end_cells))
+		return false;
+
+	for (const auto& start_cell : start_cells)
+	{
+		for (const auto& end_cell : end_cells)
+		{
+			if (!IsCellsPairBlocked(start_cell, end_cell))
+				return false;
+		}
+	}
+
+	INC_DWORD_STAT(STAT_VEN_LineOfSightGridBlockedAnswers);
+	return true;
+}
+
+void UVEN_LineOfSightGrid::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_VEN_BuildLineOfSightGrid);
+
+	const UWorld* world = m_battle ? m_battle->GetWorld() : nullptr;
+	if (!world)
+		return;
+
+	//take rows until the frame budget is covered, every row is written by its own task
+	const int32 cells_count = m_eye_points.Num();
+	const int32 first_row = m_traced_rows_count;
+	int32 pairs_count = 0;
+	while (m_traced_rows_count < cells_count && pairs_count < MAX_TRACES_PER_FRAME)
+		pairs_count += cells_count - ++m_traced_rows_count;
+
+	const float max_distance_squared = m_max_distance * m_max_distance;
+	ParallelFor(m_traced_rows_count - first_row, [&](int32 row_offset)
+	{
+		const int32 i = first_row + row_offset;
+		auto& row = m_rows[i];
+		row.Init(false, cells_count - i - 1);
+
+		for (int32 j = i + 1; j < cells_count; ++j)
+		{
+			if (FVector::DistSquared2D(m_eye_points[i], m_eye_points[j]) > max_distance_squared)
+				continue;
+
+			row[j - i - 1] = world->LineTraceTestByChannel(m_eye_points[i], m_eye_points[j], ECC_Visibility, m_trace_params);
+		}
+	});
+
+	INC_DWORD_STAT_BY(STAT_VEN_LineOfSightGridPairsTraced, pairs_count);
+	SET_DWORD_STAT(STAT_VEN_LineOfSightGridRowsLeft, cells_count - m_traced_rows_count);
+}
+
+bool UVEN_LineOfSightGrid::IsTickable() const
+{
+	return m_traced_rows_count < m_rows.Num();
+}
+
+TStatId UVEN_LineOfSightGrid::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UVEN_LineOfSightGrid, STATGROUP_Tickables);
+}
+
+int32 UVEN_LineOfSightGrid::GetGridIndex(const FVector& location) const
+{
+	const int32 x = FMath::FloorToInt((location.X - m_origin.X) / CELL_SIZE);
+	const int32 y = FMath::FloorToInt((location.Y - m_origin.Y) / CELL_SIZE);
+	if (x < 0 || y < 0 || x >= m_cells_per_side || y >= m_cells_per_side)
+		return INDEX_NONE;
+
+	return x + y * m_cells_per_side;
+}
+
+bool UVEN_LineOfSightGrid::GatherNearbyCells(const FVector& location, TArray<int32, TInlineAllocator<4>>& cells) const
+{
+	//cells whose centers surround the location
+	const int32 min_x = FMath::FloorToInt((location.X - m_origin.X) / CELL_SIZE - .5f);
+	const int32 min_y = FMath::FloorToInt((location.Y - m_origin.Y) / CELL_SIZE - .5f);
+
+	for (int32 y = min_y; y <= min_y + 1; ++y)
+	{
+		for (int32 x = min_x; x <= min_x + 1; ++x)
+		{
+			if (x < 0 || y < 0 || x >= m_cells_per_side || y >= m_cells_per_side)
+				return false;
+
+			const int32 cell = m_cells_indices[x + y * m_cells_per_side];
+			if (cell == INDEX_NONE || FMath::Abs(m_eye_points[cell].Z - location.Z) > EYE_HEIGHT_TOLERANCE)
+				return false;
+
+			cells.AddUnique(cell);
+		}
+	}
+
+	return true;
+}
+
+bool UVEN_LineOfSightGrid::IsCellsPairBlocked(int32 from_cell, int32 to_cell) const
+{
+	if (from_cell == to_cell)
+		return false;
+
+	const int32 row = FMath::Min(from_cell, to_cell);
+	const int32 column = FMath::Max(from_cell, to_cell);
+
+	//pair is not traced yet or is never traced
+	if (row >= m_traced_rows_count || FVector::DistSquared2D(m_eye_points[row], m_eye_points[column]) > m_max_distance * m_max_distance)
+		return false;
+
+	return m_rows[row][column - row - 1];
+}
\ No newline at end of file
@@ -72,6 +72,13 @@ void AVEN_MainController::Tick(float DeltaTime)
 
 }
 
+void AVEN_MainController::PlayerTick(float DeltaTime)
+{
+	APlayerController::PlayerTick(DeltaTime);
+
+	HandleCursorMovement();
+}
+
 void AVEN_MainController::Initialize()
 {
 	if (!GetGameMode()->GetPlayerUnits().Num())
@@ -210,14 +217,13 @@ void AVEN_MainController::LockMainController(bool lock)
 	{
 		main_camera->RotationRelease();
 
+		//running battles do not touch the flag, new ones are simply held back while locked
 		m_cached_battle_is_allowed = battle_system->GetBattleAllowed();
-		if (!battle_system->IsBattleInProgress())
-			battle_system->SetBattleAllowed(false);
+		battle_system->SetBattleAllowed(false);
 	}
 	else
 	{
-		if (!battle_system->IsBattleInProgress())
-			battle_system->SetBattleAllowed(m_cached_battle_is_allowed);
+		battle_system->SetBattleAllowed(m_cached_battle_is_allowed);
 	}
 }
 
@@ -267,8 +273,6 @@ void AVEN_MainController::MouseYaw(float axis)
 	const auto& main_camera = GetGameMode()->GetMainCamera();
 	if (main_camera)
 		main_camera->OnMouseAction(input_bindings::MOUSE_ACTION::MOUSE_MOVE_X, axis);
-	HandlePlayerUnitMouseAction(input_bindings::MOUSE_ACTION::MOUSE_MOVE_X, axis);
-	HandleActorOnHover();
 }
 
 void AVEN_MainController::MousePitch(float axis)
@@ -279,8 +283,6 @@ void AVEN_MainController::MousePitch(float axis)
 	const auto& main_camera = GetGameMode()->GetMainCamera();
 	if (main_camera)
 		main_camera->OnMouseAction(input_bindings::MOUSE_ACTION::MOUSE_MOVE_Y, axis);
-	HandlePlayerUnitMouseAction(input_bindings::MOUSE_ACTION::MOUSE_MOVE_Y, axis);
-	HandleActorOnHover();
 }
 
 void AVEN_MainController::MouseScrollUp()
@@ -386,16 +388,14 @@ void AVEN_MainController::HandlePlayerUnitMouseAction(input_bindings::MOUSE_ACTI
 
 	if (mouse_action == input_bindings::MOUSE_ACTION::MOUSE_LEFT)
 	{
-		FHitResult HitResultVisibility;
-		GetHitResultUnderCursor(ECollisionChannel::ECC_Visibility, false, HitResultVisibility);
+		const auto& HitResultVisibility = GetCursorHitResult();
 		HandlePlayerUnitSelection(HitResultVisibility);
 	}
 	else if (mouse_action == input_bindings::MOUSE_ACTION::MOUSE_MOVE_X ||
 		mouse_action == input_bindings::MOUSE_ACTION::MOUSE_MOVE_Y ||
 		mouse_action == input_bindings::MOUSE_ACTION::MOUSE_RIGHT)
 	{
-		FHitResult HitResultVisibility;
-		GetHitResultUnderCursor(ECollisionChannel::ECC_Visibility, false, HitResultVisibility);
+		const auto& HitResultVisibility = GetCursorHitResult();
 
 		if (mouse_action == input_bindings::MOUSE_ACTION::MOUSE_RIGHT)
 			HandlePlayerUnitSelection(HitResultVisibility, true);
@@ -440,9 +440,7 @@ void AVEN_MainController::HandleActorOnHover()
 	if (m_is_locked)
 		return;
 
-	FHitResult HitResultVisibility;
-	GetHitResultUnderCursor(ECollisionChannel::ECC_Visibility, false, HitResultVisibility);
-	const auto& hovered_actor = HitResultVisibility.GetActor();
+	const auto& hovered_actor = GetCursorHitResult().GetActor();
 	const auto& camera = GetGameMode()->GetMainCamera();
 	if (!camera)
 		return;
@@ -557,6 +555,24 @@ void AVEN_MainController::HandleActorOnHover()
 	}
 }
 
+void AVEN_MainController::HandleCursorMovement()
+{
+	if (m_is_locked)
+		return;
+
+	//mouse axes are bound every frame, cursor consumers are updated once after both of them are processed
+	HandlePlayerUnitMouseAction(input_bindings::MOUSE_ACTION::MOUSE_MOVE_X);
+	HandleActorOnHover();
+}
+
+const FHitResult& AVEN_MainController::GetCursorHitResult()
+{
+	const auto& cursor_query_service = GetGameMode()->GetCursorQueryService();
+	cursor_query_service->Update(this);
+
+	return cursor_query_service->GetHitResult();
+}
+
 AVEN_GameMode* AVEN_MainController::GetGameMode()
 {
 	auto game_mode = Cast<AVEN_GameMode>(GetWorld()->GetAuthGameMode());
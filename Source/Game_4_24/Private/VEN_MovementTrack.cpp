@@ -0,0 +1,107 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "VEN_MovementTrack.h"
+#include "VEN_Stats.h"
+
+#include "Components/SplineComponent.h"
+
+DECLARE_CYCLE_STAT(TEXT("Movement Track Build"), STAT_VEN_MovementTrackBuild, STATGROUP_Vendetta);
+
+namespace
+{
+	//a few samples per tick of walking, error against the spline stays far below a capsule radius
+	constexpr const float SAMPLE_STEP = 10.f;
+	//long paths are sampled sparser instead of growing the track
+	constexpr const int32 MAX_SAMPLES_COUNT = 1024;
+}
+
+FVEN_MovementTrack::FVEN_MovementTrack()
+	: m_length(0.f)
+	, m_step(SAMPLE_STEP)
+{
+
+}
+
+void FVEN_MovementTrack::Reset()
+{
+	m_locations.Reset();
+	m_yaws.Reset();
+	m_length = 0.f;
+	m_step = SAMPLE_STEP;
+}
+
+void FVEN_MovementTrack::Build(const USplineComponent* spline_component)
+{
+	SCOPE_CYCLE_COUNTER(STAT_VEN_MovementTrackBuild);
+
+	Reset();
+	if (!spline_component || spline_component->GetNumberOfSplinePoints() < 2)
+		return;
+
+	m_length = spline_component->GetSplineLength();
+	const int32 segments_count = FMath::Clamp(FMath::CeilToInt(m_length / SAMPLE_STEP), 1, MAX_SAMPLES_COUNT - 1);
+	m_step = FMath::Max(m_length / segments_count, KINDA_SMALL_NUMBER);
+
+	m_locations.SetNumUninitialized(segments_count + 1);
+	m_yaws.SetNumUninitialized(segments_count + 1);
+
+	for (int32 i = 0; i <= segments_count; ++i)
+	{
+		const float distance = i * m_step;
+		m_locations[i] = spline_component->GetLocationAtDistanceAlongSpline(distance, ESplineCoordinateSpace::World);
+		m_yaws[i] = spline_component->GetRotationAtDistanceAlongSpline(distance, ESplineCoordinateSpace::World).Yaw;
+	}
+
+	//tangent vanishes at the clamped end point, its rotation is always zero
+	m_yaws[segments_count] = m_yaws[segments_count - 1];
+}
+
+bool FVEN_MovementTrack::IsBuilt() const
+{
+	return m_locations.Num() > 0;
+}
+
+float FVEN_MovementTrack::GetLength() const
+{
+	return m_length;
+}
+
+FVector FVEN_MovementTrack::GetLocationAtDistance(float distance) const
+{
+	if (!IsBuilt())
+		return FVector::ZeroVector;
+
+	float alpha = 0.f;
+	const int32 index = GetSampleIndex(distance, alpha);
+	return FMath::Lerp(m_locations[index], m_locations[index + 1], alpha);
+}
+
+float FVEN_MovementTrack::GetYawAtDistance(float distance) const
+{
+	if (!IsBuilt())
+		return 0.f;
+
+	float alpha = 0.f;
+	const int32 index = GetSampleIndex(distance, alpha);
+	const float yaw_delta = FRotator::NormalizeAxis(m_yaws[index + 1] - m_yaws[index]);
+	return FRotator::NormalizeAxis(m_yaws[index] + yaw_delta * alpha);
+}
+
+FVector FVEN_MovementTrack::GetEndLocation() const
+{
+	return IsBuilt() ? m_locations.Last() : FVector::ZeroVector;
+}
+
+float FVEN_MovementTrack::GetEndYaw() const
+{
+	return IsBuilt() ? m_yaws.Last() : 0.f;
+}
+
+int32 FVEN_MovementTrack::GetSampleIndex(float distance, float& alpha) const
+{
+	const float position = FMath::Clamp(distance, 0.f, m_length) / m_step;
+	const int32 index = FMath::Min(FMath::FloorToInt(position), m_locations.Num() - 2);
+	alpha = FMath::Clamp(position - index, 0.f, 1.f);
+	return index;
+}
\ No newline at end of file
@@ -0,0 +1,283 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "VEN_NavigationFilter.h"
+#include "VEN_GameMode.h"
+#include "VEN_BattleSystem.h"
+
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "Components/CapsuleComponent.h"
+#include "NavigationSystem.h"
+#include "NavMesh/RecastNavMesh.h"
+#include "NavMesh/RecastHelpers.h"
+#include "Detour/DetourNavMesh.h"
+
+namespace
+{
+	constexpr const float BLOCKED_SEGMENT_COST_MULTIPLIER = 100.f;
+	constexpr const float AVOIDANCE_MARGIN = 20.f;
+	//a few blockers around a path, more means the way is closed
+	constexpr const int MAX_DETOURS_COUNT = 16;
+	const FVector PROJECTION_EXTENT = FVector(50.f, 50.f, 250.f);
+
+#if WITH_RECAST
+	//detour filter which knows about units: polygons fully covered by a unit are excluded,
+	//segments passing through a unit become expensive
+	class FVEN_BlockersQueryFilter : public FRecastQueryFilter
+	{
+	public:
+
+		FVEN_BlockersQueryFilter(const TArray<FVEN_NavigationBlocker>& blockers)
+		{
+			//detour works in recast space, y is up there
+			for (const auto& blocker : blockers)
+			{
+				const FVector recast_location = Unreal2RecastPoint(blocker.location);
+				m_blockers.Add({ FVector2D(recast_location.X, recast_location.Z), blocker.radius });
+			}
+		}
+
+		INavigationQueryFilterInterface* CreateCopy() const override
+		{
+			return new FVEN_BlockersQueryFilter(*this);
+		}
+
+	protected:
+
+		bool passVirtualFilter(const dtPolyRef ref, const dtMeshTile* tile, const dtPoly* poly) const override
+		{
+			if (!passInlineFilter(ref, tile, poly))
+				return false;
+
+			for (const auto& blocker : m_blockers)
+			{
+				bool is_covered = true;
+				for (int i = 0; i < poly->vertCount && is_covered; ++i)
+				{
+					const float* vertex = &tile->verts[poly->verts[i] * 3];
+					is_covered = FVector2D::Distance(FVector2D(vertex[0], vertex[2]), blocker.location) < blocker.radius;
+				}
+
+				if (is_covered)
+					return false;
+			}
+
+			return true;
+		}
+
+		float getVirtualCost(const float* pa, const float* pb,
+			const dtPolyRef prevRef, const dtMeshTile* prevTile, const dtPoly* prevPoly,
+			const dtPolyRef curRef, const dtMeshTile* curTile, const dtPoly* curPoly,
+			const dtPolyRef nextRef, const dtMeshTile* nextTile, const dtPoly* nextPoly) const override
+		{
+			const float cost = getInlineCost(pa, pb, prevRef, prevTile, prevPoly, curRef, curTile, curPoly, nextRef, nextTile, nextPoly);
+			const FVector2D segment_start(pa[0], pa[2]);
+			const FVector2D segment_end(pb[0], pb[2]);
+
+			for (const auto& blocker : m_blockers)
+			{
+				if (FVector2D::Distance(FMath::ClosestPointOnSegment2D(blocker.location, segment_start, segment_end), blocker.location) < blocker.radius)
+					return cost * BLOCKED_SEGMENT_COST_MULTIPLIER;
+			}
+
+			return cost;
+		}
+
+	private:
+
+		struct FRecastBlocker
+		{
+			FVector2D location;
+			float radius;
+		};
+
+		TArray<FRecastBlocker> m_blockers;
+	};
+#endif
+}
+
+UVEN_NavigationFilter::UVEN_NavigationFilter()
+{
+	//blockers are taken from current battle state on every query
+	bInstantiateForQuerier = true;
+}
+
+bool UVEN_NavigationFilter::AvoidBlockers(const UObject* querier, TArray<FVector>& path_points)
+{
+	if (!querier || path_points.Num() < 2)
+		return true;
+
+	TArray<FVEN_NavigationBlocker> blockers;
+	GatherBlockers(querier, blockers);
+	if (!blockers.Num())
+		return true;
+
+	UWorld* world = querier->GetWorld();
+	const auto& navigation_system = FNavigationSystem::GetCurrent<UNavigationSystemV1>(world);
+	if (!navigation_system)
+		return true;
+
+	const TArray<FVector> source_path_points = path_points;
+	int detours_count = 0;
+
+	//segment is checked again after a detour is inserted into it, both halves may cross other blockers
+	int i = 1;
+	while (i < path_points.Num())
+	{
+		const FVector segment_start = path_points[i - 1];
+		const FVector segment_end = path_points[i];
+
+		const auto crossed_blocker = FindCrossedBlocker(blockers, segment_start, segment_end);
+		if (!crossed_blocker)
+		{
+			++i;
+			continue;
+		}
+
+		if (++detours_count > MAX_DETOURS_COUNT)
+		{
+			//debug_log("UVEN_NavigationFilter::AvoidBlockers. Too many detours", FColor::Red);
+			path_points = source_path_points;
+			return false;
+		}
+
+		const FVector closest_point = FMath::ClosestPointOnSegment(crossed_blocker->location, segment_start, segment_end);
+		FVector detour_direction = (closest_point - crossed_blocker->location).GetSafeNormal2D();
+		if (detour_direction.IsNearlyZero())
+			detour_direction = FVector(segment_start.Y - segment_end.Y, segment_end.X - segment_start.X, 0.f).GetSafeNormal2D();
+
+		bool detour_is_found = false;
+		for (const float side : { 1.f, -1.f })
+		{
+			const FVector desired_point = crossed_blocker->location + detour_direction * side * (crossed_blocker->radius + AVOIDANCE_MARGIN);
+			FNavLocation detour_point;
+			if (!navigation_system->ProjectPointToNavigation(FVector(desired_point.X, desired_point.Y, closest_point.Z), detour_point, PROJECTION_EXTENT))
+				continue;
+
+			if (IsInsideBlocker(blockers, detour_point.Location))
+				continue;
+
+			FVector hit_location;
+			if (!UNavigationSystemV1::NavigationRaycast(world, segment_start, detour_point.Location, hit_location) &&
+				!UNavigationSystemV1::NavigationRaycast(world, detour_point.Location, segment_end, hit_location))
+			{
+				path_points.Insert(detour_point.Location, i);
+				detour_is_found = true;
+				break;
+			}
+		}
+
+		if (!detour_is_found)
+		{
+			path_points = source_path_points;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+float UVEN_NavigationFilter::EstimateDetourLength(const TArray<FVEN_NavigationBlocker>& blockers, const TArray<FVector>& path_points)
+{
+	float detour_length = 0.f;
+
+	for (int i = 1; i < path_points.Num(); ++i)
+	{
+		for (const auto& blocker : blockers)
+		{
+			if (FVector::Dist2D(path_points[i - 1], blocker.location) < blocker.radius || FVector::Dist2D(path_points[i], blocker.location) < blocker.radius)
+				continue;
+
+			const FVector closest_point = FMath::ClosestPointOnSegment(blocker.location, path_points[i - 1], path_points[i]);
+			const float distance = FVector::Dist2D(closest_point, blocker.location);
+			if (distance >= blocker.radius)
+				continue;
+
+			//arc on the near side minus the chord it replaces
+			const float arc_length = 2.f * blocker.radius * FMath::Acos(distance / blocker.radius);
+			const float chord_length = 2.f * FMath::Sqrt(FMath::Square(blocker.radius) - FMath::Square(distance));
+			detour_length += arc_length - chord_length;
+		}
+	}
+
+	return detour_length;
+}
+
+void UVEN_NavigationFilter::InitializeFilter(const ANavigationData& NavData, const UObject* Querier, FNavigationQueryFilter& Filter) const
+{
+	if (!Filter.GetImplementation())
+		Filter.SetFilterImplementation(NavData.GetDefaultQueryFilterImpl());
+
+#if WITH_RECAST
+	TArray<FVEN_NavigationBlocker> blockers;
+	GatherBlockers(Querier, blockers);
+
+	const auto& source_filter = Filter.GetImplementation();
+	if (blockers.Num() && source_filter)
+	{
+		float area_costs[RECAST_MAX_AREAS];
+		float area_fixed_costs[RECAST_MAX_AREAS];
+		source_filter->GetAllAreaCosts(area_costs, area_fixed_costs, RECAST_MAX_AREAS);
+
+		FVEN_BlockersQueryFilter blockers_filter(blockers);
+		blockers_filter.SetAllAreaCosts(area_costs, RECAST_MAX_AREAS);
+		for (int i = 0; i < RECAST_MAX_AREAS; ++i)
+			blockers_filter.SetFixedAreaEnteringCost(i, area_fixed_costs[i]);
+		blockers_filter.SetIncludeFlags(source_filter->GetIncludeFlags());
+		blockers_filter.SetExcludeFlags(source_filter->GetExcludeFlags());
+
+		Filter.SetFilterImplementation(&blockers_filter);
+	}
+#endif
+
+	Super::InitializeFilter(NavData, Querier, Filter);
+}
+
+void UVEN_NavigationFilter::GatherBlockers(const UObject* querier, TArray<FVEN_NavigationBlocker>& blockers)
+{
+	const auto& world = querier ? querier->GetWorld() : nullptr;
+	const auto& game_mode = world ? Cast<AVEN_GameMode>(world->GetAuthGameMode()) : nullptr;
+	const auto& battle_system = game_mode ? game_mode->GetBattleSystem() : nullptr;
+	//only units of the querier battle block its paths
+	const auto& battle = battle_system ? battle_system->GetBattle(Cast<AActor>(querier)) : nullptr;
+	if (!battle)
+		return;
+
+	//keep capsules apart, not only their centers
+	const auto& querier_character_c = Cast<ACharacter>(querier);
+	const float querier_radius = querier_character_c ? querier_character_c->GetCapsuleComponent()->GetScaledCapsuleRadius() : 0.f;
+
+	for (const auto& blocker : battle->GetNavigationBlockers())
+	{
+		if (blocker.owner != querier)
+			blockers.Add({ blocker.location, blocker.radius + querier_radius, blocker.owner });
+	}
+}
+
+const FVEN_NavigationBlocker* UVEN_NavigationFilter::FindCrossedBlocker(const TArray<FVEN_NavigationBlocker>& blockers, const FVector& segment_start, const FVector& segment_end)
+{
+	for (const auto& blocker : blockers)
+	{
+		//unit already standing in a blocker or heading into one cannot go around it
+		if (FVector::Dist2D(segment_start, blocker.location) < blocker.radius || FVector::Dist2D(segment_end, blocker.location) < blocker.radius)
+			continue;
+
+		const FVector closest_point = FMath::ClosestPointOnSegment(blocker.location, segment_start, segment_end);
+		if (FVector::Dist2D(closest_point, blocker.location) < blocker.radius)
+			return &blocker;
+	}
+
+	return nullptr;
+}
+
+bool UVEN_NavigationFilter::IsInsideBlocker(const TArray<FVEN_NavigationBlocker>& blockers, const FVector& location)
+{
+	for (const auto& blocker : blockers)
+	{
+		if (FVector::Dist2D(location, blocker.location) < blocker.radius)
+			return true;
+	}
+
+	return false;
+}
\ No newline at end of file
@@ -0,0 +1,295 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "VEN_NavigationService.h"
+#include "VEN_NavigationFilter.h"
+#include "VEN_ReachabilityField.h"
+#include "VEN_Stats.h"
+
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "Components/CapsuleComponent.h"
+#include "NavigationSystem.h"
+#include "NavigationData.h"
+#include "NavMesh/RecastNavMesh.h"
+#include "Detour/DetourNavMesh.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Path Queries"), STAT_VEN_PathQueries, STATGROUP_Vendetta);
+DECLARE_CYCLE_STAT(TEXT("Build Reachability Field"), STAT_VEN_BuildReachabilityField, STATGROUP_Vendetta);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Reachability Field Polygons"), STAT_VEN_ReachabilityFieldPolygons, STATGROUP_Vendetta);
+
+namespace
+{
+	constexpr const float REACHABILITY_CELL_SIZE = 50.f;
+	const FVector NEAREST_POLY_EXTENT = FVector(50.f, 50.f, 250.f);
+}
+
+UVEN_NavigationService::UVEN_NavigationService()
+	: m_last_batch_id(0)
+{
+
+}
+
+void UVEN_NavigationService::Initialize()
+{
+	m_paths_batches.Empty();
+}
+
+bool UVEN_NavigationService::FindPath(const AActor* querier, const FVector& start_point, const FVector& destination_point, TArray<FVector>& path_points) const
+{
+	path_points.Reset();
+
+	const auto& navigation_system = GetNavigationSystem();
+	const auto& navigation_data = GetNavigationData(querier, start_point);
+	if (!navigation_system || !navigation_data)
+	{
+		//debug_log("UVEN_NavigationService::FindPath. Navigation data not found", FColor::Red);
+		return false;
+	}
+
+	INC_DWORD_STAT(STAT_VEN_PathQueries);
+
+	const auto& query_filter = UNavigationQueryFilter::GetQueryFilter(*navigation_data, querier, UVEN_NavigationFilter::StaticClass());
+	const FPathFindingQuery query(querier, *navigation_data, start_point, destination_point, query_filter);
+	const FPathFindingResult result = navigation_system->FindPathSync(query);
+	if (!result.IsSuccessful() || !result.Path.IsValid())
+		return false;
+
+	for (const auto& path_point : result.Path->GetPathPoints())
+		path_points.Add(path_point.Location);
+
+	return UVEN_NavigationFilter::AvoidBlockers(querier, path_points) && path_points.Num() > 0;
+}
+
+bool UVEN_NavigationService::IsReachable(const AActor* querier, const FVector& destination_point, float* path_length) const
+{
+	TArray<FVector> path_points;
+	if (!FindPath(querier, GetQueryStartPoint(querier), destination_point, path_points))
+		return false;
+
+	if (path_length)
+		*path_length = CalculatePathLength(path_points);
+
+	return true;
+}
+
+uint32 UVEN_NavigationService::FindPathsAsync(const AActor* querier, const TArray<FVector>& destination_points, const FVEN_OnPathBatchCompleted& callback)
+{
+	const uint32 batch_id = ++m_last_batch_id;
+	auto& batch = m_paths_batches.Add(batch_id);
+	batch.querier = querier;
+	batch.callback = callback;
+	UVEN_NavigationFilter::GatherBlockers(querier, batch.blockers);
+	batch.results.SetNum(destination_points.Num());
+	for (int i = 0; i < destination_points.Num(); ++i)
+		batch.results[i].destination_point = destination_points[i];
+
+	const FVector start_point = GetQueryStartPoint(querier);
+	const auto& navigation_system = GetNavigationSystem();
+	const auto& navigation_data = GetNavigationData(querier, start_point);
+
+	if (navigation_system && navigation_data)
+	{
+		//filter is instantiated once, all queries of batch see the same blockers
+		const auto& query_filter = UNavigationQueryFilter::GetQueryFilter(*navigation_data, querier, UVEN_NavigationFilter::StaticClass());
+		const auto& querier_character_c = Cast<ACharacter>(querier);
+		const FNavAgentProperties& agent_properties = querier_character_c ? querier_character_c->GetNavAgentPropertiesRef() : FNavAgentProperties::DefaultProperties;
+
+		for (int i = 0; i < destination_points.Num(); ++i)
+		{
+			const FPathFindingQuery query(querier, *navigation_data, start_point, destination_points[i], query_filter);
+			navigation_system->FindPathAsync(agent_properties, query, FNavPathQueryDelegate::CreateUObject(this, &UVEN_NavigationService::OnAsyncPathFound, batch_id, i));
+			batch.pending_queries_count++;
+			INC_DWORD_STAT(STAT_VEN_PathQueries);
+		}
+	}
+	//else
+		//debug_log("UVEN_NavigationService::FindPathsAsync. Navigation data not found", FColor::Red);
+
+	if (!batch.pending_queries_count)
+		CompletePathsBatch(batch_id);
+
+	return batch_id;
+}
+
+void UVEN_NavigationService::CancelPathsBatch(uint32 batch_id)
+{
+	//results of already submitted queries are ignored
+	m_paths_batches.Remove(batch_id);
+}
+
+bool UVEN_NavigationService::BuildReachabilityField(const AActor* querier, float max_cost, FVEN_ReachabilityField& field) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_VEN_BuildReachabilityField);
+
+	field.Reset();
+
+#if WITH_RECAST
+	const FVector start_point = GetQueryStartPoint(querier);
+	const auto& nav_mesh = Cast<const ARecastNavMesh>(GetNavigationData(querier, start_point));
+	const auto& detour_nav_mesh = nav_mesh ? nav_mesh->GetRecastMesh() : nullptr;
+	if (!detour_nav_mesh || max_cost <= 0.f)
+	{
+		//debug_log("UVEN_NavigationService::BuildReachabilityField. Recast navmesh not found", FColor::Red);
+		return false;
+	}
+
+	//same filter as path queries, polygons covered by other units are not entered
+	const auto& query_filter = UNavigationQueryFilter::GetQueryFilter(*nav_mesh, querier, UVEN_NavigationFilter::StaticClass());
+	const auto& recast_filter = query_filter.IsValid() ? static_cast<const FRecastQueryFilter*>(query_filter->GetImplementation()) : nullptr;
+	const auto& detour_filter = recast_filter ? recast_filter->GetAsDetourQueryFilter() : nullptr;
+
+	const NavNodeRef start_poly = nav_mesh->FindNearestPoly(start_point, NEAREST_POLY_EXTENT, query_filter, querier);
+	if (start_poly == INVALID_NAVNODEREF)
+		return false;
+
+	//the same blockers path queries go around, their detours are part of the cost
+	TArray<FVEN_NavigationBlocker> blockers;
+	UVEN_NavigationFilter::GatherBlockers(querier, blockers);
+	field.Setup(start_point, max_cost, REACHABILITY_CELL_SIZE, blockers);
+
+	struct FOpenPoly
+	{
+		float cost;
+		NavNodeRef poly;
+	};
+	const auto by_cost = [](const FOpenPoly& a, const FOpenPoly& b) { return a.cost < b.cost; };
+
+	TMap<NavNodeRef, int32> poly_nodes;
+	TArray<FOpenPoly> open_polys;
+	TArray<FNavigationPortalEdge> portals;
+
+	poly_nodes.Add(start_poly, field.AddNode(start_point, 0.f));
+	open_polys.HeapPush({ 0.f, start_poly }, by_cost);
+
+	while (open_polys.Num())
+	{
+		FOpenPoly current;
+		open_polys.HeapPop(current, by_cost);
+
+		//polygon was reached cheaper after this entry was queued
+		const int32 current_node = poly_nodes.FindChecked(current.poly);
+		if (current.cost > field.GetNodeCost(current_node))
+			continue;
+
+		const FVector current_entry_point = field.GetNodeEntryPoint(current_node);
+
+		portals.Reset();
+		nav_mesh->GetPolyNeighbors(current.poly, portals);
+
+		for (const auto& portal : portals)
+		{
+			if (detour_filter)
+			{
+				const dtMeshTile* tile = nullptr;
+				const dtPoly* poly = nullptr;
+				if (dtStatusFailed(detour_nav_mesh->getTileAndPolyByRef(portal.ToRef, &tile, &poly)) || !detour_filter->passFilter(portal.ToRef, tile, poly))
+					continue;
+			}
+
+			//neighbour is entered through the closest portal point, which keeps straight runs straight
+			const FVector entry_point = FMath::ClosestPointOnSegment(current_entry_point, portal.Left, portal.Right);
+			const float cost = current.cost + field.GetSegmentCost(current_entry_point, entry_point);
+			if (cost > max_cost)
+				continue;
+
+			const auto& known_node = poly_nodes.Find(portal.ToRef);
+			if (known_node && field.GetNodeCost(*known_node) <= cost)
+				continue;
+
+			if (known_node)
+				field.UpdateNode(*known_node, entry_point, cost);
+			else
+				poly_nodes.Add(portal.ToRef, field.AddNode(entry_point, cost));
+
+			open_polys.HeapPush({ cost, portal.ToRef }, by_cost);
+		}
+	}
+
+	TArray<FVector> poly_verts;
+	for (const auto& poly_node : poly_nodes)
+	{
+		if (nav_mesh->GetPolyVerts(poly_node.Key, poly_verts))
+			field.RasterizeNode(poly_node.Value, poly_verts);
+	}
+
+	SET_DWORD_STAT(STAT_VEN_ReachabilityFieldPolygons, poly_nodes.Num());
+	return field.IsValid();
+#else
+	return false;
+#endif
+}
+
+FVector UVEN_NavigationService::GetQueryStartPoint(const AActor* querier) const
+{
+	if (!querier)
+		return FVector::ZeroVector;
+
+	//paths start from capsule bottom, same as movement splines
+	const auto& querier_character_c = Cast<ACharacter>(querier);
+	if (!querier_character_c)
+		return querier->GetActorLocation();
+
+	FVector start_point = querier_character_c->GetCapsuleComponent()->GetComponentLocation();
+	start_point.Z -= querier_character_c->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+	return start_point;
+}
+
+float UVEN_NavigationService::CalculatePathLength(const TArray<FVector>& path_points)
+{
+	float path_length = 0.f;
+	for (int i = 1; i < path_points.Num(); ++i)
+		path_length += FVector::Dist(path_points[i - 1], path_points[i]);
+
+	return path_length;
+}
+
+UNavigationSystemV1* UVEN_NavigationService::GetNavigationSystem() const
+{
+	return FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+}
+
+const ANavigationData* UVEN_NavigationService::GetNavigationData(const AActor* querier, const FVector& location) const
+{
+	const auto& navigation_system = GetNavigationSystem();
+	if (!navigation_system)
+		return nullptr;
+
+	const auto& querier_character_c = Cast<ACharacter>(querier);
+	if (querier_character_c)
+		return navigation_system->GetNavDataForProps(querier_character_c->GetNavAgentPropertiesRef(), location);
+
+	return navigation_system->GetDefaultNavDataInstance(FNavigationSystem::DontCreate);
+}
+
+void UVEN_NavigationService::OnAsyncPathFound(uint32 query_id, ENavigationQueryResult::Type query_result, FNavPathSharedPtr path, uint32 batch_id, int32 result_index)
+{
+	auto batch = m_paths_batches.Find(batch_id);
+	if (!batch || !batch->results.IsValidIndex(result_index))
+		return;
+
+	if (query_result == ENavigationQueryResult::Success && path.IsValid())
+	{
+		TArray<FVector> path_points;
+		for (const auto& path_point : path->GetPathPoints())
+			path_points.Add(path_point.Location);
+
+		//detours are only estimated here, the chosen path goes through AvoidBlockers when it is built
+		auto& result = batch->results[result_index];
+		result.is_reachable = path_points.Num() > 0;
+		result.path_length = CalculatePathLength(path_points) + UVEN_NavigationFilter::EstimateDetourLength(batch->blockers, path_points);
+	}
+
+	batch->pending_queries_count--;
+	if (batch->pending_queries_count <= 0)
+		CompletePathsBatch(batch_id);
+}
+
+void UVEN_NavigationService::CompletePathsBatch(uint32 batch_id)
+{
+	FPathsBatch batch;
+	if (!m_paths_batches.RemoveAndCopyValue(batch_id, batch))
+		return;
+
+	batch.callback.ExecuteIfBound(batch.results);
+}
\ No newline at end of file
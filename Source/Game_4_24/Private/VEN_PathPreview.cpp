@@ -0,0 +1,137 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "VEN_PathPreview.h"
+#include "VEN_Stats.h"
+
+#include "Components/SplineComponent.h"
+#include "Components/SplineMeshComponent.h"
+#include "Engine/StaticMesh.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Path Preview Updates"), STAT_VEN_PathPreviewUpdates, STATGROUP_Vendetta);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Path Preview Segments Pool"), STAT_VEN_PathPreviewSegmentsPool, STATGROUP_Vendetta);
+
+AVEN_PathPreview::AVEN_PathPreview()
+	: m_spline(nullptr)
+	, m_segment_mesh(nullptr)
+	, m_start_point(FVector::ZeroVector)
+	, m_visible_segments_count(0)
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	m_spline = CreateDefaultSubobject<USplineComponent>("PathSpline");
+	m_spline->SetMobility(EComponentMobility::Movable);
+	m_spline->SetCanEverAffectNavigation(false);
+	SetRootComponent(m_spline);
+}
+
+void AVEN_PathPreview::SetPath(const FVector& start_point, const TArray<FVector>& path_points, UStaticMesh* segment_mesh)
+{
+	if (!path_points.Num())
+	{
+		Clear();
+		return;
+	}
+
+	//the same path is hovered again, just show it back if it was hidden
+	if (start_point == m_start_point && segment_mesh == m_segment_mesh && path_points == m_path_points)
+	{
+		UpdateSegments();
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_VEN_PathPreviewUpdates);
+
+	m_start_point = start_point;
+	m_path_points = path_points;
+	m_segment_mesh = segment_mesh;
+
+	SetActorLocation(start_point);
+
+	//first point is the start point itself, the first path point matches it
+	m_spline->ClearSplinePoints(false);
+	m_spline->AddSplinePoint(start_point, ESplineCoordinateSpace::World, false);
+	for (int i = 1; i < path_points.Num(); ++i)
+	{
+		m_spline->AddSplinePoint(path_points[i], ESplineCoordinateSpace::World, false);
+		m_spline->SetSplinePointType(i, ESplinePointType::CurveClamped, false);
+	}
+	m_spline->UpdateSpline();
+
+	//force segments to pick up new spline
+	m_visible_segments_count = INDEX_NONE;
+	UpdateSegments();
+}
+
+void AVEN_PathPreview::Hide()
+{
+	for (int32 i = 0; i < m_visible_segments_count; ++i)
+		m_segments[i]->SetVisibility(false);
+
+	m_visible_segments_count = 0;
+}
+
+void AVEN_PathPreview::Clear()
+{
+	Hide();
+
+	m_path_points.Empty();
+	m_start_point = FVector::ZeroVector;
+	m_spline->ClearSplinePoints();
+}
+
+bool AVEN_PathPreview::HasPath() const
+{
+	return m_path_points.Num() > 0;
+}
+
+USplineComponent* AVEN_PathPreview::GetSpline() const
+{
+	return m_spline;
+}
+
+void AVEN_PathPreview::UpdateSegments()
+{
+	const int32 segments_count = m_segment_mesh ? m_spline->GetNumberOfSplinePoints() - 1 : 0;
+	if (segments_count == m_visible_segments_count)
+		return;
+
+	for (int32 i = 0; i < segments_count; ++i)
+	{
+		const auto& segment = i < m_segments.Num() ? m_segments[i] : CreateSegment();
+
+		segment->SetStaticMesh(m_segment_mesh);
+		segment->SetStartAndEnd
+		(
+			m_spline->GetLocationAtSplinePoint(i, ESplineCoordinateSpace::Local),
+			m_spline->GetTangentAtSplinePoint(i, ESplineCoordinateSpace::Local),
+			m_spline->GetLocationAtSplinePoint(i + 1, ESplineCoordinateSpace::Local),
+			m_spline->GetTangentAtSplinePoint(i + 1, ESplineCoordinateSpace::Local)
+		);
+		segment->SetVisibility(true);
+	}
+
+	//pooled segments beyond the path are kept hidden
+	for (int32 i = segments_count; i < m_segments.Num(); ++i)
+		m_segments[i]->SetVisibility(false);
+
+	m_visible_segments_count = segments_count;
+}
+
+USplineMeshComponent* AVEN_PathPreview::CreateSegment()
+{
+	const FString COMPONENT_NAME = "PathSegment" + FString::FromInt(m_segments.Num());
+
+	USplineMeshComponent* segment = NewObject<USplineMeshComponent>(this, *COMPONENT_NAME);
+	segment->SetMobility(EComponentMobility::Movable);
+	segment->SetForwardAxis(ESplineMeshAxis::Z, false);
+	segment->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	segment->SetCanEverAffectNavigation(false);
+	segment->SetupAttachment(m_spline);
+	segment->RegisterComponent();
+
+	m_segments.Add(segment);
+	INC_DWORD_STAT(STAT_VEN_PathPreviewSegmentsPool);
+
+	return segment;
+}
\ No newline at end of file
@@ -0,0 +1,204 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "VEN_PerceptionManager.h"
+#include "VEN_GameMode.h"
+#include "VEN_EnemyUnit.h"
+#include "VEN_PlayerUnit.h"
+#include "VEN_BattleSystem.h"
+#include "VEN_Stats.h"
+
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Perception Tick"), STAT_VEN_PerceptionTick, STATGROUP_Vendetta);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Perception Candidates"), STAT_VEN_PerceptionCandidates, STATGROUP_Vendetta);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Perception Line Of Sight Checks"), STAT_VEN_PerceptionLineOfSightChecks, STATGROUP_Vendetta);
+
+namespace
+{
+	constexpr const int32 MAX_LINE_OF_SIGHT_CHECKS_PER_FRAME = 8;
+}
+
+UVEN_PerceptionManager::UVEN_PerceptionManager()
+	: m_max_sensing_radius(0.f)
+	, m_next_check_index(0)
+	, m_is_initialized(false)
+{
+
+}
+
+void UVEN_PerceptionManager::Initialize()
+{
+	Uninitialize();
+	m_is_initialized = true;
+}
+
+void UVEN_PerceptionManager::Uninitialize()
+{
+	m_is_initialized = false;
+	m_enemy_units.Empty();
+	m_max_sensing_radius = 0.f;
+	m_pending_checks.Empty();
+	m_next_check_index = 0;
+}
+
+void UVEN_PerceptionManager::RegisterEnemyUnit(AVEN_EnemyUnit* enemy_unit)
+{
+	if (!enemy_unit)
+		return;
+
+	if (!m_enemy_units.Contains(enemy_unit))
+		m_enemy_units.Add(enemy_unit);
+
+	m_max_sensing_radius = FMath::Max(m_max_sensing_radius, enemy_unit->GetSensingRadius());
+}
+
+void UVEN_PerceptionManager::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_VEN_PerceptionTick);
+
+	//units in battle are skipped one by one, sensing goes on elsewhere
+	const auto& game_mode = GetGameMode();
+	if (!game_mode || !game_mode->GetBattleSystem())
+		return;
+
+	bool sweep_is_started = false;
+	int32 line_of_sight_checks_left = MAX_LINE_OF_SIGHT_CHECKS_PER_FRAME;
+
+	while (line_of_sight_checks_left > 0)
+	{
+		//start next sweep, but not twice in one frame
+		if (m_next_check_index >= m_pending_checks.Num())
+		{
+			if (sweep_is_started)
+				break;
+
+			PrepareChecks();
+			sweep_is_started = true;
+
+			if (!m_pending_checks.Num())
+				break;
+		}
+
+		if (ProcessCheck(m_pending_checks[m_next_check_index++]))
+		{
+			line_of_sight_checks_left--;
+			INC_DWORD_STAT(STAT_VEN_PerceptionLineOfSightChecks);
+		}
+	}
+}
+
+bool UVEN_PerceptionManager::IsTickable() const
+{
+	return m_is_initialized;
+}
+
+TStatId UVEN_PerceptionManager::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UVEN_PerceptionManager, STATGROUP_Tickables);
+}
+
+AVEN_GameMode* UVEN_PerceptionManager::GetGameMode() const
+{
+	const auto& world = GetWorld();
+	const auto& game_mode = world ? Cast<AVEN_GameMode>(world->GetAuthGameMode()) : nullptr;
+	//if (!game_mode)
+		//debug_log("UVEN_PerceptionManager::GetGameMode. Game Mode not found!", FColor::Red);
+
+	return game_mode;
+}
+
+void UVEN_PerceptionManager::PrepareChecks()
+{
+	m_pending_checks.Reset();
+	m_next_check_index = 0;
+
+	//enemy units which are already sensing follow only their target and go first
+	for (const auto& enemy_unit : m_enemy_units)
+	{
+		if (enemy_unit && enemy_unit->IsSensingActive())
+			m_pending_checks.Add({ enemy_unit, Cast<AVEN_PlayerUnit>(enemy_unit->GetSensingTarget()) });
+	}
+
+	const auto& units_spatial_hash = GetGameMode()->GetUnitsSpatialHash();
+	if (!units_spatial_hash)
+		return;
+
+	const auto& battle_system = GetGameMode()->GetBattleSystem();
+
+	TArray<AActor*> nearby_units;
+	for (const auto& player_unit : GetGameMode()->GetPlayerUnits())
+	{
+		if (!player_unit || player_unit->IsDead() || battle_system->IsInBattle(player_unit))
+			continue;
+
+		const FVector player_unit_location = player_unit->GetActorLocation();
+		nearby_units.Reset();
+		units_spatial_hash->GatherUnits(player_unit_location, m_max_sensing_radius, nearby_units, AVEN_EnemyUnit::StaticClass());
+
+		for (const auto& nearby_unit : nearby_units)
+		{
+			const auto& enemy_unit = Cast<AVEN_EnemyUnit>(nearby_unit);
+			if (!enemy_unit || enemy_unit->IsDead() || !enemy_unit->IsSensingEnabled() || enemy_unit->IsSensingActive())
+				continue;
+
+			if (FVector::DistSquared(enemy_unit->GetActorLocation(), player_unit_location) <= FMath::Square(enemy_unit->GetSensingRadius()))
+				m_pending_checks.Add({ enemy_unit, player_unit });
+		}
+	}
+
+	SET_DWORD_STAT(STAT_VEN_PerceptionCandidates, m_pending_checks.Num());
+}
+
+bool UVEN_PerceptionManager::ProcessCheck(const FPerceptionCheck& check)
+{
+	const auto& enemy_unit = check.enemy_unit;
+	const auto& player_unit = check.player_unit;
+	if (!IsValid(enemy_unit) || !IsValid(player_unit) || enemy_unit->IsDead() || !enemy_unit->IsSensingEnabled())
+		return false;
+
+	//sensing could be started or finished since checks were prepared
+	if (enemy_unit->IsSensingActive())
+	{
+		if (enemy_unit->GetSensingTarget() != player_unit)
+			return false;
+
+		//target fighting elsewhere is lost as well, sensing cools down
+		if (!enemy_unit->IsInSensingCone(player_unit) || GetGameMode()->GetBattleSystem()->IsInBattle(player_unit))
+		{
+			enemy_unit->OnSensingTargetVisibilityUpdate(false);
+			return false;
+		}
+	}
+	else if (player_unit->IsDead() || !enemy_unit->IsInSensingCone(player_unit))
+	{
+		return false;
+	}
+
+	const auto& visibility_service = GetGameMode()->GetVisibilityService();
+	if (!visibility_service)
+		return false;
+
+	const auto& callback = FVEN_OnVisibilityChecked::CreateUObject(this, &UVEN_PerceptionManager::OnVisibilityChecked, TWeakObjectPtr<AVEN_EnemyUnit>(enemy_unit), TWeakObjectPtr<AVEN_PlayerUnit>(player_unit));
+	visibility_service->QueryVisibility(enemy_unit, player_unit, enemy_unit->GetSensingViewPoint(), callback);
+	return true;
+}
+
+void UVEN_PerceptionManager::OnVisibilityChecked(bool is_visible, TWeakObjectPtr<AVEN_EnemyUnit> enemy_unit_ptr, TWeakObjectPtr<AVEN_PlayerUnit> player_unit_ptr)
+{
+	const auto& enemy_unit = enemy_unit_ptr.Get();
+	const auto& player_unit = player_unit_ptr.Get();
+	if (!m_is_initialized || !enemy_unit || !player_unit || enemy_unit->IsDead())
+		return;
+
+	//result comes next frame, sensing state could be changed meanwhile
+	if (enemy_unit->IsSensingActive())
+	{
+		if (enemy_unit->GetSensingTarget() == player_unit)
+			enemy_unit->OnSensingTargetVisibilityUpdate(is_visible);
+	}
+	else if (is_visible)
+	{
+		enemy_unit->OnPlayerUnitSensed(player_unit);
+	}
+}
\ No newline at end of file
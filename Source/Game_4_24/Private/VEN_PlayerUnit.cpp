@@ -9,9 +9,14 @@
 #include "VEN_EnemyUnit.h"
 #include "VEN_Camera.h"
 #include "VEN_BattleSystem.h"
+#include "VEN_BattleCore.h"
 #include "VEN_AnimInstance.h"
 #include "VEN_CursorManager.h"
 #include "VEN_TactialView.h"
+#include "VEN_NavigationFilter.h"
+#include "VEN_PathPreview.h"
+#include "VEN_NavigationService.h"
+#include "VEN_InteractionPoint.h"
 #include "VEN_Types.h"
 #include "VEN_FreeFunctions.h"
 
@@ -27,7 +32,6 @@
 #include "TimerManager.h"
 #include "UObject/ConstructorHelpers.h"
 #include "Components/SplineComponent.h"
-#include "Components/SplineMeshComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "Components/CapsuleComponent.h"
 #include "Components/DecalComponent.h"
@@ -48,7 +52,7 @@ using namespace vendetta;
 
 AVEN_PlayerUnit::AVEN_PlayerUnit()
 	: m_is_active(false)
-	, m_movement_spline_actor_temporary(nullptr)
+	, m_movement_path_preview(nullptr)
 	, m_movement_spline_component_temporary(nullptr)
 	, m_movement_spline_actor_fixed(nullptr)
 	, m_movement_spline_component_fixed(nullptr)
@@ -62,6 +66,8 @@ AVEN_PlayerUnit::AVEN_PlayerUnit()
 	, m_temporary_movement_spline_is_built(false)
 	, m_movement_spline_is_visualized(false)
 	, m_spline_comleted_movement_distance(0.f)
+	, m_hovered_movement_price(0.f)
+	, m_hovered_movement_price_is_used(false)
 {
 	PrimaryActorTick.bCanEverTick = true;
 
@@ -76,6 +82,9 @@ AVEN_PlayerUnit::AVEN_PlayerUnit()
 
 	m_decal = CreateDefaultSubobject<UDecalComponent>("ActiveUnitDecal");
 	m_decal->SetupAttachment(RootComponent);
+
+	//units never dirty navmesh, in battle they are avoided by path queries
+	GetCapsuleComponent()->SetCanEverAffectNavigation(false);
 }
 
 void AVEN_PlayerUnit::BeginPlay()
@@ -86,6 +95,15 @@ void AVEN_PlayerUnit::BeginPlay()
 	m_show_advanced_cursor = false;
 }
 
+void AVEN_PlayerUnit::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	const auto& game_mode = GetGameMode();
+	if (game_mode && game_mode->GetUnitsSpatialHash())
+		game_mode->GetUnitsSpatialHash()->UnregisterUnit(this);
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void AVEN_PlayerUnit::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
@@ -123,11 +141,14 @@ void AVEN_PlayerUnit::Initialize()
 	RegisterTacticalViewInstance();
 	InitBattleRelatedProperties();
 	NotifyBlueprint();
+	GetGameMode()->GetUnitsSpatialHash()->RegisterUnit(this);
+	UpdateTickEnabled();
 }
 
 void AVEN_PlayerUnit::Uninitialize()
 {
 	DestroyDestinationPointActor();
+	DestroyMovementPathPreview();
 	DisableTacticalView();
 }
 
@@ -192,7 +213,7 @@ void AVEN_PlayerUnit::OnAnimationUpdate(ANIMATION_NOTIFICATION notification)
 	if (notification == ANIMATION_NOTIFICATION::ATTACK_ANIMATION_UPDATED)
 	{
 		const auto& battle_system = GetBattleSystem();
-		if (battle_system && battle_system->IsBattleInProgress() && m_focused_target && m_is_active)
+		if (battle_system && battle_system->IsInBattle(this) && m_focused_target && m_is_active)
 		{
 			GetBattleSystem()->Attack(this, m_focused_target);
 			if (m_in_battle)
@@ -258,7 +279,7 @@ void AVEN_PlayerUnit::OnStartBattle()
 		DestroyDestinationPointActor();
 
 		if (!GetActive())
-			DestroyMovementSpline(m_movement_spline_actor_temporary);
+			HideMovementPathPreview();
 	}
 
 	ResetBattleRelatedProperties();
@@ -268,11 +289,14 @@ void AVEN_PlayerUnit::OnStartBattle()
 
 	m_in_battle = true;
 	m_hp_recovery = false;
+	UpdateTickEnabled();
 }
 
 void AVEN_PlayerUnit::OnFinishBattle()
 {
 	m_in_battle = false;
+	m_reachability_field.Reset();
+	m_hovered_movement_price_is_used = false;
 	DisableTacticalView();
 	UpdateBattleTurnInfo(false);
 
@@ -284,7 +308,6 @@ void AVEN_PlayerUnit::OnFinishBattle()
 			AnimInstanceUpdate(ANIMATION_UPDATE::FINISH_STUN);
 
 		m_is_dead = false;
-		GetCapsuleComponent()->SetCanEverAffectNavigation(false);
 	}
 
 	AnimInstanceUpdate(ANIMATION_UPDATE::FINISH_BATTLE);
@@ -293,12 +316,15 @@ void AVEN_PlayerUnit::OnFinishBattle()
 	// recover hp after battle
 	if (m_hp_current < m_hp_total * HP_RECOVERY_PERCENT)
 		m_hp_recovery = true;
+
+	UpdateTickEnabled();
 }
 
 void AVEN_PlayerUnit::OnStartBattleTurn()
 {
 	m_decal->SetVisibility(true);
 	SetActive(true);
+	UpdateReachabilityField();
 	UpdateBattleTurnInfo();
 	GetGameMode()->GetMainCamera()->SetCameraFollowMode(true, this);
 
@@ -311,7 +337,9 @@ void AVEN_PlayerUnit::OnFinishBattleTurn()
 	m_decal->SetVisibility(false);
 	UpdateCursor(nullptr);
 	SetActive(false);
-	DestroyMovementSpline(m_movement_spline_actor_temporary);
+	HideMovementPathPreview();
+	m_reachability_field.Reset();
+	m_hovered_movement_price_is_used = false;
 
 	m_show_advanced_cursor = false;
 	UpdateAdvancedCursor(nullptr, false);
@@ -351,7 +379,7 @@ void AVEN_PlayerUnit::OnReceiveDamage(float damage_received, AActor* damage_deal
 	}
 
 	NotifyBlueprint();
-	GetBattleSystem()->UpdateBlueprintBattleQueue();
+	GetBattleSystem()->UpdateBlueprintBattleQueue(this);
 }
 
 vendetta::ATTACK_TYPE AVEN_PlayerUnit::GetAttackType() const
@@ -369,9 +397,9 @@ int AVEN_PlayerUnit::GetTotalHP() const
 	return m_hp_total;
 }
 
-int AVEN_PlayerUnit::GetRandomAttackPower() const
+int AVEN_PlayerUnit::GetRandomAttackPower(FRandomStream& random_stream) const
 {
-	return FMath::RandRange(m_attack_power_min, m_attack_power_max);
+	return random_stream.RandRange(m_attack_power_min, m_attack_power_max);
 }
 
 int AVEN_PlayerUnit::GetAttackRange() const
@@ -408,7 +436,7 @@ void AVEN_PlayerUnit::UpdateTurnPoints(float update_on_value)
 	}
 
 	NotifyBlueprint();
-	GetBattleSystem()->UpdateBlueprintBattleQueue();
+	GetBattleSystem()->UpdateBlueprintBattleQueue(this);
 
 	if (m_in_battle)
 		UpdateBattleTurnInfo();
@@ -424,6 +452,59 @@ bool AVEN_PlayerUnit::IsDead() const
 	return m_is_dead;
 }
 
+BATTLE_FACTION AVEN_PlayerUnit::GetBattleFaction() const
+{
+	return BATTLE_FACTION::PLAYER;
+}
+
+FVEN_BattleUnitRecord AVEN_PlayerUnit::GetBattleUnitRecord() const
+{
+	FVEN_BattleUnitRecord record;
+	record.faction = GetBattleFaction();
+	record.hp_current = m_hp_current;
+	record.hp_total = m_hp_total;
+	record.hp_on_defeat = 1;
+	record.turn_points_left = m_turn_points_left;
+	record.turn_points_total = m_turn_points_total;
+	record.attack_power_min = m_attack_power_min;
+	record.attack_power_max = m_attack_power_max;
+	record.attack_range = m_attack_range;
+	record.attack_price = m_attack_price;
+	record.is_dead = m_is_dead;
+	return record;
+}
+
+bool AVEN_PlayerUnit::ApplyBattleUnitRecord(const FVEN_BattleUnitRecord& record)
+{
+	//recorded hp is kept as is, recovery after battle must not change it
+	m_hp_recovery = false;
+	m_hp_current = FMath::Clamp(record.hp_current, 1, m_hp_total);
+
+	if (record.is_dead && !m_is_dead)
+	{
+		Die();
+	}
+	else if (!record.is_dead && m_is_dead)
+	{
+		m_is_dead = false;
+		AnimInstanceUpdate(ANIMATION_UPDATE::FINISH_STUN);
+	}
+
+	UpdateTickEnabled();
+	NotifyBlueprint();
+	GetBattleSystem()->UpdateBlueprintBattleQueue(this);
+	return true;
+}
+
+FBattleQueueUnitInfo AVEN_PlayerUnit::GetBattleQueueUnitInfo() const
+{
+	FBattleQueueUnitInfo info;
+	info.icon_type = m_unit_icon_type;
+	info.hp_percent = (float)GetHP() / (float)GetTotalHP();
+	info.tps_percent = GetTurnPointsLeft() / GetTurnPointsTotal();
+	return info;
+}
+
 void AVEN_PlayerUnit::ToggleTacticalView()
 {
 	if (m_tactical_view_is_allowed)
@@ -435,6 +516,11 @@ void AVEN_PlayerUnit::ToggleTacticalView()
 	}
 }
 
+const FVEN_ReachabilityField& AVEN_PlayerUnit::GetReachabilityField() const
+{
+	return m_reachability_field;
+}
+
 void AVEN_PlayerUnit::OnUpdateFromTacticalView(FVector main_area_center_point, FVector minor_area_center_point, const TArray<FEnemyUnitInfo>& enemy_units_info)
 {
 	OnTacticalViewUpdate(true, enemy_units_info);
@@ -486,7 +572,7 @@ void AVEN_PlayerUnit::HandleMouseAction(FHitResult hit_result, input_bindings::M
 		ProcessInteractableActorOnHover(hit_result.GetActor());
 
 		if (!m_move_and_interact_spline_calculated)
-			BuildTemporaryMovementSpline(hit_result.Location);
+			UpdateHoveredMovementPrice(hit_result.Location);
 
 		UpdateCursor(hit_result.GetActor());
 
@@ -579,11 +665,13 @@ void AVEN_PlayerUnit::HandleMouseAction(FHitResult hit_result, input_bindings::M
 
 void AVEN_PlayerUnit::BuildTemporaryMovementSpline(const FVector& destination_point)
 {
-	//destroy previous temporary spline if any
-	DestroyMovementSpline(m_movement_spline_actor_temporary);
+	m_hovered_movement_price_is_used = false;
 
 	if (m_in_battle && m_is_currently_moving)
+	{
+		HideMovementPathPreview();
 		return;
+	}
 
 	//calculate navigation path
 	float half_capsule_height = 0.f;
@@ -592,67 +680,33 @@ void AVEN_PlayerUnit::BuildTemporaryMovementSpline(const FVector& destination_po
 	FVector start_movement_point = GetCapsuleComponent()->GetComponentLocation();
 	start_movement_point.Z -= half_capsule_height;
 
-	UNavigationPath* movement_path = UNavigationSystemV1::FindPathToLocationSynchronously(GetWorld(), start_movement_point, destination_point, this);
-	m_temporary_movement_spline_is_built = (movement_path->PathPoints.Num() > 0);
-
-	if (!m_temporary_movement_spline_is_built)
-		return;
+	UNavigationPath* movement_path = UNavigationSystemV1::FindPathToLocationSynchronously(GetWorld(), start_movement_point, destination_point, this, UVEN_NavigationFilter::StaticClass());
+	m_temporary_movement_spline_is_built = UVEN_NavigationFilter::AvoidBlockers(this, movement_path->PathPoints) && movement_path->PathPoints.Num() > 0;
 
-	//create temporary spline based on path
-	FActorSpawnParameters spawn_params;
-	m_movement_spline_actor_temporary = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), start_movement_point, FRotator::ZeroRotator, spawn_params);
-	m_movement_spline_component_temporary = NewObject<USplineComponent>(m_movement_spline_actor_temporary, "Movement Spline");
-	m_movement_spline_component_temporary->RegisterComponent();
-	m_movement_spline_component_temporary->RemoveSplinePoint(1);
+	if (!m_movement_path_preview)
+		SpawnMovementPathPreview();
 
-	if (!m_movement_spline_component_temporary)
+	if (!m_movement_path_preview)
 		return;
 
-	m_movement_spline_actor_temporary->SetRootComponent(m_movement_spline_component_temporary);
-	m_movement_spline_actor_temporary->SetActorLocation(start_movement_point);
-
-	//setup created spline with points
-	for (int i = 1; i < movement_path->PathPoints.Num(); ++i)
+	if (!m_temporary_movement_spline_is_built)
 	{
-		m_movement_spline_component_temporary->AddSplinePoint(movement_path->PathPoints[i], ESplineCoordinateSpace::World);
-		m_movement_spline_component_temporary->SetSplinePointType(i, ESplinePointType::CurveClamped);
+		m_movement_path_preview->Clear();
+		return;
 	}
 
 	//visualize spline with meshes
+	UStaticMesh* movement_spline_mesh = nullptr;
 	if (m_movement_spline_is_visualized)
-	{
-		for (int i = 0; i < m_movement_spline_component_temporary->GetNumberOfSplinePoints() - 1; ++i)
-		{
-			const FString COMPONENT_NAME = "Movement Spline Mesh" + FString::FromInt(i);
-
-			USplineMeshComponent* spline_mesh_comp = NewObject<USplineMeshComponent>(m_movement_spline_actor_temporary, *COMPONENT_NAME);
-			spline_mesh_comp->RegisterComponent();
+		movement_spline_mesh = IsEnoughPointsForAction(IN_BATTLE_UNIT_ACTION::MOVE) ? m_movement_spline_mesh_enabled : m_movement_spline_mesh_disabled;
 
-			const auto& movement_spline_mesh = IsEnoughPointsForAction(IN_BATTLE_UNIT_ACTION::MOVE) ? m_movement_spline_mesh_enabled : m_movement_spline_mesh_disabled;
-			if (spline_mesh_comp && movement_spline_mesh)
-			{
-				spline_mesh_comp->SetMobility(EComponentMobility::Movable);
-				spline_mesh_comp->SetStaticMesh(movement_spline_mesh);
-				spline_mesh_comp->SetForwardAxis(ESplineMeshAxis::Z);
-
-				spline_mesh_comp->SetStartAndEnd
-				(
-					m_movement_spline_component_temporary->GetLocationAtSplinePoint(i, ESplineCoordinateSpace::Local),
-					m_movement_spline_component_temporary->GetTangentAtSplinePoint(i, ESplineCoordinateSpace::Local),
-					m_movement_spline_component_temporary->GetLocationAtSplinePoint(i + 1, ESplineCoordinateSpace::Local),
-					m_movement_spline_component_temporary->GetTangentAtSplinePoint(i + 1, ESplineCoordinateSpace::Local)
-				);
-
-				FAttachmentTransformRules attachment_rules(EAttachmentRule::KeepRelative, true);
-				spline_mesh_comp->AttachToComponent(m_movement_spline_component_temporary, attachment_rules);
-			}
-		}
-	}
+	//preview is reused, spline and segments are only updated when path is changed
+	m_movement_path_preview->SetPath(start_movement_point, movement_path->PathPoints, movement_spline_mesh);
 }
 
 void AVEN_PlayerUnit::BuildFixedMovementSpline()
 {
-	if (!m_movement_spline_actor_temporary || !m_movement_spline_component_temporary)
+	if (!m_movement_path_preview || !m_movement_path_preview->HasPath())
 	{
 		//debug_log("AVEN_PlayerUnit::BuildFixedMovementSpline. Movement spline is corrupted", FColor::Red);
 		return;
@@ -688,6 +742,61 @@ void AVEN_PlayerUnit::DestroyMovementSpline(AActor* movement_spline)
 	}
 }
 
+void AVEN_PlayerUnit::SpawnMovementPathPreview()
+{
+	FActorSpawnParameters spawn_params;
+	m_movement_path_preview = GetWorld()->SpawnActor<AVEN_PathPreview>(AVEN_PathPreview::StaticClass(), GetActorLocation(), FRotator::ZeroRotator, spawn_params);
+
+	if (!m_movement_path_preview)
+	{
+		//debug_log("AVEN_PlayerUnit::SpawnMovementPathPreview. Path preview cannot be spawned", FColor::Red);
+		return;
+	}
+
+	m_movement_spline_component_temporary = m_movement_path_preview->GetSpline();
+}
+
+void AVEN_PlayerUnit::HideMovementPathPreview()
+{
+	if (m_movement_path_preview)
+		m_movement_path_preview->Hide();
+}
+
+void AVEN_PlayerUnit::DestroyMovementPathPreview()
+{
+	if (m_movement_path_preview)
+		m_movement_path_preview->Destroy();
+
+	m_movement_path_preview = nullptr;
+	m_movement_spline_component_temporary = nullptr;
+	m_temporary_movement_spline_is_built = false;
+}
+
+void AVEN_PlayerUnit::UpdateHoveredMovementPrice(const FVector& destination_point)
+{
+	if (!m_in_battle || !m_reachability_field.IsValid())
+	{
+		BuildTemporaryMovementSpline(destination_point);
+		return;
+	}
+
+	//price is a field lookup, path itself is built on click
+	HideMovementPathPreview();
+	m_hovered_movement_price_is_used = true;
+	m_temporary_movement_spline_is_built = m_reachability_field.GetMoveCost(destination_point, m_hovered_movement_price);
+}
+
+void AVEN_PlayerUnit::UpdateReachabilityField()
+{
+	m_reachability_field.Reset();
+	m_hovered_movement_price_is_used = false;
+
+	if (!m_in_battle || !GetGameMode() || !GetGameMode()->GetNavigationService())
+		return;
+
+	GetGameMode()->GetNavigationService()->BuildReachabilityField(this, GetTurnPointsLeft(), m_reachability_field);
+}
+
 void AVEN_PlayerUnit::BuildDestinationPointActor(FVector destination_point)
 {
 	DestroyDestinationPointActor();
@@ -757,11 +866,24 @@ float AVEN_PlayerUnit::CalculateTimeToCompleteMovementSpline(USplineComponent* s
 		return 0.f;
 	}
 
-	return (spline_component->GetSplineLength() / GetMovementComponent()->GetMaxSpeed());
+	return CalculateTimeToCompleteMovement(spline_component->GetSplineLength());
+}
+
+float AVEN_PlayerUnit::CalculateTimeToCompleteMovement(float movement_length)
+{
+	return (movement_length / GetMovementComponent()->GetMaxSpeed());
 }
 
 void AVEN_PlayerUnit::PrepareMovement(FHitResult hit_result)
 {
+	//only price was known on hover, build the real path now
+	if (m_hovered_movement_price_is_used)
+	{
+		BuildTemporaryMovementSpline(hit_result.Location);
+		if (m_in_battle && !IsEnoughPointsForAction(IN_BATTLE_UNIT_ACTION::MOVE))
+			return;
+	}
+
 	if (m_temporary_movement_spline_is_built)
 	{
 		if ((RootComponent->GetComponentLocation() - hit_result.ImpactPoint).Size() > MOVEMENT_MIN_DISTANCE)
@@ -789,41 +911,43 @@ void AVEN_PlayerUnit::StartMovement()
 		return;
 	}
 
+	m_movement_track.Build(m_movement_spline_component_fixed);
 	m_anim_instance->OnUpdateFromOwner(ANIMATION_UPDATE::START_MOVEMENT);
 	m_is_currently_moving = true;
+	UpdateTickEnabled();
 
 	//notify main controller
-	const auto& destination_location = m_movement_spline_component_fixed->GetLocationAtSplinePoint(m_movement_spline_component_fixed->GetNumberOfSplinePoints() - 1, ESplineCoordinateSpace::World);
-	const auto& destination_rotation = m_movement_spline_component_fixed->GetRotationAtDistanceAlongSpline(m_movement_spline_component_fixed->GetSplineLength() * 0.99, ESplineCoordinateSpace::World);
-	GetMainController()->UnitStartedMovement(this, destination_location, destination_rotation, CalculateTimeToCompleteMovementSpline(m_movement_spline_component_fixed));
+	const auto& destination_location = m_movement_track.GetEndLocation();
+	const auto& destination_rotation = FRotator(0.f, m_movement_track.GetEndYaw(), 0.f);
+	GetMainController()->UnitStartedMovement(this, destination_location, destination_rotation, CalculateTimeToCompleteMovement(m_movement_track.GetLength()));
+
+	if (m_in_battle)
+		GetBattleSystem()->RecordMovement(this, GetActorLocation(), destination_location);
 }
 
 void AVEN_PlayerUnit::ContinueMovement()
 {
-	if (!m_movement_spline_component_fixed)
+	if (!m_movement_spline_component_fixed || !m_movement_track.IsBuilt())
 	{
-		//debug_log("AVEN_PlayerUnit::ContinueMovement. Spline component is missing", FColor::Red);
+		//debug_log("AVEN_PlayerUnit::ContinueMovement. Movement track is missing", FColor::Red);
 		return;
 	}
 
-	if (m_spline_comleted_movement_distance < m_movement_spline_component_fixed->GetSplineLength())
+	if (m_spline_comleted_movement_distance < m_movement_track.GetLength())
 	{
 		m_spline_comleted_movement_distance += GetVelocity().Size() * GetWorld()->GetDeltaSeconds();
 
 		AddMovementInput(GetActorForwardVector(), 1.0f, true);
 
-		FVector spline_location = m_movement_spline_component_fixed->GetLocationAtDistanceAlongSpline(m_spline_comleted_movement_distance, ESplineCoordinateSpace::World);
-		FRotator spline_rotation = m_movement_spline_component_fixed->GetRotationAtDistanceAlongSpline(m_spline_comleted_movement_distance, ESplineCoordinateSpace::World);
-
-		spline_location.Z = GetCapsuleComponent()->GetComponentLocation().Z;
-		spline_rotation.SetComponentForAxis(EAxis::X, 0.f);
-		spline_rotation.SetComponentForAxis(EAxis::Y, 0.f);
+		FVector track_location = m_movement_track.GetLocationAtDistance(m_spline_comleted_movement_distance);
+		track_location.Z = GetCapsuleComponent()->GetComponentLocation().Z;
 
-		SetActorLocation(spline_location);
+		SetActorLocation(track_location);
+		GetGameMode()->GetUnitsSpatialHash()->UpdateUnitLocation(this);
 
-		//do not set unit rotation at last spline point - it will always be equal 0.0f
-		if (m_movement_spline_component_fixed && m_spline_comleted_movement_distance < (m_movement_spline_component_fixed->GetSplineLength() - 10.f))
-			SetActorRotation(spline_rotation);
+		//keep heading on the last few centimeters, sampled yaw there is unreliable
+		if (m_spline_comleted_movement_distance < (m_movement_track.GetLength() - 10.f))
+			SetActorRotation(FRotator(0.f, m_movement_track.GetYawAtDistance(m_spline_comleted_movement_distance), 0.f));
 	}
 	else
 	{
@@ -835,18 +959,25 @@ void AVEN_PlayerUnit::ContinueMovement()
 		DestroyDestinationPointActor();
 
 		if (!GetActive())
-			DestroyMovementSpline(m_movement_spline_actor_temporary);
+			HideMovementPathPreview();
 	}
 }
 
 void AVEN_PlayerUnit::FinishMovement()
 {
+	//last tick overshoots the track, only the track itself is paid for
 	if (m_in_battle)
-		UpdateTurnPoints(-m_spline_comleted_movement_distance);
+		UpdateTurnPoints(-FMath::Min(m_spline_comleted_movement_distance, m_movement_track.GetLength()));
 
 	m_spline_comleted_movement_distance = 0.f;
 	m_is_currently_moving = false;
 	m_movement_spline_component_fixed = nullptr;
+	m_movement_track.Reset();
+	UpdateTickEnabled();
+
+	//unit is at new location with less turn points
+	if (m_reachability_field.IsValid())
+		UpdateReachabilityField();
 
 	GetWorldTimerManager().ClearTimer(m_tmr_before_move);
 	GetMainController()->UnitFinishedMovement(this);
@@ -990,7 +1121,9 @@ float AVEN_PlayerUnit::GetMovementPrice() const
 {
 	float price = 0.f;
 
-	if (m_movement_spline_component_temporary)
+	if (m_hovered_movement_price_is_used)
+		price = m_temporary_movement_spline_is_built ? m_hovered_movement_price : 0.f;
+	else if (m_movement_spline_component_temporary)
 		price = m_movement_spline_component_temporary->GetSplineLength();
 
 	return price;
@@ -1074,7 +1207,7 @@ void AVEN_PlayerUnit::ProcessInteractableActorOnHover(AActor* actor)
 		//do nothing if in range
 		if (calculate_distance(GetActorLocation(), target_location, true) <= interaction_range)
 		{
-			DestroyMovementSpline(m_movement_spline_actor_temporary);
+			HideMovementPathPreview();
 			return;
 		}
 
@@ -1082,7 +1215,7 @@ void AVEN_PlayerUnit::ProcessInteractableActorOnHover(AActor* actor)
 		BuildTemporaryMovementSpline(target_location);
 		FVector interaction_point_location = GetInteractPointLocation(actor, interaction_range);
 		m_move_and_interact_spline_calculated = interaction_point_location != FVector::ZeroVector;
-		m_move_and_interact_spline_calculated ? BuildTemporaryMovementSpline(interaction_point_location) : DestroyMovementSpline(m_movement_spline_actor_temporary);
+		m_move_and_interact_spline_calculated ? BuildTemporaryMovementSpline(interaction_point_location) : HideMovementPathPreview();
 	}
 }
 
@@ -1122,33 +1255,9 @@ FVector AVEN_PlayerUnit::GetInteractPointLocation(AActor* interactable_actor, fl
 	if (!m_movement_spline_component_temporary)
 		return FVector::ZeroVector;
 
-	const FVector target_location = interactable_actor->GetActorLocation();
-	const int CHECKPOINTS_FREQUENCY_FACTOR = 50;
-	const int CHECKPOINTS_COUNT = (int)(m_movement_spline_component_temporary->GetSplineLength() / CHECKPOINTS_FREQUENCY_FACTOR);
-
-	for (int i = 0; i < CHECKPOINTS_COUNT; ++i)
-	{
-		const float time_at_current_checkpoint = (m_movement_spline_component_temporary->Duration / CHECKPOINTS_COUNT) * i;
-		FVector checkpoint_location = m_movement_spline_component_temporary->GetLocationAtTime(time_at_current_checkpoint, ESplineCoordinateSpace::World);
-		checkpoint_location.Z += GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
-
-		//target is too far from current checkpoint
-		if (calculate_distance(checkpoint_location, target_location, true) > interaction_radius)
-			continue;
-
-		//trace if is interation range
-		FHitResult trace_hit_result;
-		FCollisionQueryParams trace_params;
-		trace_params.AddIgnoredActor(this);
-
-		if (GetWorld()->LineTraceSingleByChannel(trace_hit_result, checkpoint_location, target_location, ECC_Visibility, trace_params))
-		{
-			if (trace_hit_result.GetActor() == interactable_actor)
-				return checkpoint_location;
-		}
-	}
-
-	return FVector::ZeroVector;
+	const auto& battle = m_in_battle ? GetBattleSystem()->GetBattle(this) : nullptr;
+	const auto& line_of_sight_grid = battle ? battle->GetLineOfSightGrid() : nullptr;
+	return find_interaction_point(m_movement_spline_component_temporary, this, interactable_actor, interaction_radius, GetCapsuleComponent()->GetScaledCapsuleHalfHeight(), line_of_sight_grid);
 }
 
 void AVEN_PlayerUnit::ChangeFocusedTarget(AActor* new_target)
@@ -1226,7 +1335,9 @@ void AVEN_PlayerUnit::PrepareAttackAnimation()
 	RotateToFocusedTarget();
 	ANIMATION_ACTION action;
 
-	int random_attack_animation = FMath::RandRange(1, 2);
+	//rolled from the battle stream like damage
+	const auto& battle = GetBattleSystem() ? GetBattleSystem()->GetBattle(this) : nullptr;
+	int random_attack_animation = battle ? battle->GetRandomStream().RandRange(1, 2) : FMath::RandRange(1, 2);
 	if (random_attack_animation == 1)
 		action = ANIMATION_ACTION::ATTACK_1;
 	else
@@ -1293,6 +1404,7 @@ void AVEN_PlayerUnit::RecoverHPs()
 	if (m_hp_current >= hp_after_recover)
 	{
 		m_hp_recovery = false;
+		UpdateTickEnabled();
 		return;
 	}
 
@@ -1303,9 +1415,14 @@ void AVEN_PlayerUnit::RecoverHPs()
 	NotifyBlueprint();
 }
 
+void AVEN_PlayerUnit::UpdateTickEnabled()
+{
+	SetActorTickEnabled(m_is_currently_moving || m_hp_recovery);
+}
+
 bool AVEN_PlayerUnit::CanInitiateBattleInPlace(AVEN_EnemyUnit* enemy_unit)
 {
-	if (!m_anim_instance->IsFree() || m_in_battle || !GetBattleSystem()->GetBattleAllowed() || enemy_unit->IsDead())
+	if (!m_anim_instance->IsFree() || m_in_battle || !GetBattleSystem()->CanStartBattle(this, enemy_unit) || enemy_unit->IsDead())
 		return false;
 
 	return calculate_distance(GetActorLocation(), enemy_unit->GetActorLocation()) < BATTLE_INITIATE_DISTANCE;
@@ -1313,7 +1430,7 @@ bool AVEN_PlayerUnit::CanInitiateBattleInPlace(AVEN_EnemyUnit* enemy_unit)
 
 bool AVEN_PlayerUnit::CanInitiateBattleAfterMove(AVEN_EnemyUnit* enemy_unit)
 {
-	if (!m_anim_instance->IsFree() || m_in_battle || !GetBattleSystem()->GetBattleAllowed() || enemy_unit->IsDead())
+	if (!m_anim_instance->IsFree() || m_in_battle || !GetBattleSystem()->CanStartBattle(this, enemy_unit) || enemy_unit->IsDead())
 		return false;
 
 	return m_move_and_interact_spline_calculated;
@@ -1324,28 +1441,14 @@ bool AVEN_PlayerUnit::CanAttackInPlace(AVEN_EnemyUnit* enemy_unit, bool consider
 	if (!m_anim_instance->IsFree() || m_is_currently_moving || !m_in_battle || enemy_unit->IsDead() || (consider_turn_points && !IsEnoughPointsForAction(IN_BATTLE_UNIT_ACTION::ATTACK)))
 		return false;
 
-	FHitResult trace_hit_result;
-	FVector trace_start_point = GetActorLocation();
-	FVector trace_end_point = enemy_unit->GetActorLocation();
-	FCollisionQueryParams trace_params;
-	trace_params.AddIgnoredActor(this);
-
-	bool no_obstacles_on_attack_trace = true;
-	bool valid_attack_range = true;
-
-	if (GetAttackRange() < calculate_distance(trace_start_point, trace_end_point, true))
-		valid_attack_range = false;
-
-	if (GetWorld()->LineTraceSingleByChannel(trace_hit_result, trace_start_point, trace_end_point, ECC_Visibility, trace_params))
-	{
-		if (trace_hit_result.GetActor() != enemy_unit)
-			no_obstacles_on_attack_trace = false;
-	}
+	if (GetAttackRange() < calculate_distance(GetActorLocation(), enemy_unit->GetActorLocation(), true))
+		return false;
 
-	if (valid_attack_range && no_obstacles_on_attack_trace)
-		return true;
+	const auto& game_mode = GetGameMode();
+	if (!game_mode || !game_mode->GetVisibilityService())
+		return false;
 
-	return false;
+	return game_mode->GetVisibilityService()->IsVisible(this, enemy_unit, GetActorLocation());
 }
 
 bool AVEN_PlayerUnit::CanAttackAfterMove(AVEN_EnemyUnit* enemy_unit, bool consider_turn_points)
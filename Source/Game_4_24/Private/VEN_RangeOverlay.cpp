@@ -0,0 +1,117 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "VEN_RangeOverlay.h"
+#include "VEN_Stats.h"
+
+#include "Components/DecalComponent.h"
+#include "Components/SceneComponent.h"
+#include "Materials/MaterialInterface.h"
+#include "UObject/ConstructorHelpers.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Range Overlay Updates"), STAT_VEN_RangeOverlayUpdates, STATGROUP_Vendetta);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Range Overlay Circles"), STAT_VEN_RangeOverlayCircles, STATGROUP_Vendetta);
+
+using namespace vendetta;
+
+namespace
+{
+	constexpr const float DECAL_DEPTH = 500.f;
+	constexpr const float DECAL_HEIGHT_OFFSET = 450.f;
+}
+
+AVEN_RangeOverlay::AVEN_RangeOverlay()
+	: m_material_bow(nullptr)
+	, m_material_sword(nullptr)
+	, m_material_minor(nullptr)
+	, m_ground_z(0.f)
+	, m_is_visible(false)
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	static ConstructorHelpers::FObjectFinder<UMaterialInterface> MaterialBow(TEXT("MaterialInstance'/Game/Materials/TacticalView/MI_TacticalViewMainBow.MI_TacticalViewMainBow'"));
+	m_material_bow = MaterialBow.Object;
+	static ConstructorHelpers::FObjectFinder<UMaterialInterface> MaterialSword(TEXT("MaterialInstance'/Game/Materials/TacticalView/MI_TacticalViewMainSword.MI_TacticalViewMainSword'"));
+	m_material_sword = MaterialSword.Object;
+	static ConstructorHelpers::FObjectFinder<UMaterialInterface> MaterialMinor(TEXT("MaterialInstance'/Game/Materials/TacticalView/MI_TacticalViewMinor.MI_TacticalViewMinor'"));
+	m_material_minor = MaterialMinor.Object;
+
+	SetRootComponent(CreateDefaultSubobject<USceneComponent>("RangeOverlayRoot"));
+	SetActorEnableCollision(false);
+}
+
+void AVEN_RangeOverlay::SetCircles(const TArray<FVEN_RangeCircle>& circles, float ground_z)
+{
+	if (!circles.Num())
+	{
+		Hide();
+		return;
+	}
+
+	//the same circles, decals are already placed
+	if (m_is_visible && circles == m_circles && ground_z == m_ground_z)
+		return;
+
+	INC_DWORD_STAT(STAT_VEN_RangeOverlayUpdates);
+	SET_DWORD_STAT(STAT_VEN_RangeOverlayCircles, circles.Num());
+
+	m_circles = circles;
+	m_ground_z = ground_z;
+	m_is_visible = true;
+	UpdateDecals();
+}
+
+void AVEN_RangeOverlay::Hide()
+{
+	if (!m_is_visible)
+		return;
+
+	m_is_visible = false;
+	for (const auto& decal : m_decals)
+		decal->SetVisibility(false);
+}
+
+UMaterialInterface* AVEN_RangeOverlay::GetCircleMaterial(RANGE_CIRCLE_TYPE type) const
+{
+	switch (type)
+	{
+		case RANGE_CIRCLE_TYPE::OWNER_MELEE: return m_material_sword;
+		case RANGE_CIRCLE_TYPE::OWNER_RANGE: return m_material_bow;
+		case RANGE_CIRCLE_TYPE::ENEMY: return m_material_minor;
+		default: return nullptr;
+	}
+}
+
+void AVEN_RangeOverlay::UpdateDecals()
+{
+	//decals are pooled, only missing ones are created
+	for (int32 i = 0; i < m_circles.Num(); ++i)
+	{
+		if (!m_decals.IsValidIndex(i))
+		{
+			UDecalComponent* decal = NewObject<UDecalComponent>(this);
+			if (!decal)
+				return;
+
+			decal->SetMobility(EComponentMobility::Movable);
+			decal->RegisterComponent();
+			m_decals.Add(decal);
+		}
+
+		const auto& circle = m_circles[i];
+		const auto& decal = m_decals[i];
+		const auto& material = GetCircleMaterial(circle.type);
+		const float diameter = circle.radius * 2;
+
+		if (decal->GetDecalMaterial() != material)
+			decal->SetDecalMaterial(material);
+
+		decal->SetWorldLocationAndRotation(FVector(circle.center.X, circle.center.Y, m_ground_z - DECAL_HEIGHT_OFFSET), FRotator(-90.f, 0.f, 0.f));
+		decal->DecalSize = FVector(DECAL_DEPTH, diameter, diameter);
+		decal->MarkRenderStateDirty();
+		decal->SetVisibility(material != nullptr);
+	}
+
+	for (int32 i = m_circles.Num(); i < m_decals.Num(); ++i)
+		m_decals[i]->SetVisibility(false);
+}
\ No newline at end of file
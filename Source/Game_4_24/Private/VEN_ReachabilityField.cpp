@@ -0,0 +1,202 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "VEN_ReachabilityField.h"
+
+namespace
+{
+	//polygons of one navmesh level which share a cell are closer in height than this
+	constexpr const float LAYER_HEIGHT_TOLERANCE = 100.f;
+	//same as nearest polygon search, queried locations may be lifted above navmesh
+	constexpr const float LOOKUP_HEIGHT_TOLERANCE = 250.f;
+
+	//separating axis test, cell may be touched by polygon without containing any of its vertices and vice versa
+	bool does_convex_polygon_overlap_box(const TArray<FVector>& polygon_verts, const FVector2D& box_min, const FVector2D& box_max)
+	{
+		float doubled_area = 0.f;
+		for (int i = 0; i < polygon_verts.Num(); ++i)
+			doubled_area += FVector2D::CrossProduct(FVector2D(polygon_verts[i]), FVector2D(polygon_verts[(i + 1) % polygon_verts.Num()]));
+
+		const float winding_sign = FMath::Sign(doubled_area);
+		if (winding_sign == 0.f)
+			return false;
+
+		const FVector2D box_corners[] = { box_min, FVector2D(box_max.X, box_min.Y), box_max, FVector2D(box_min.X, box_max.Y) };
+		for (int i = 0; i < polygon_verts.Num(); ++i)
+		{
+			const FVector2D edge_start(polygon_verts[i]);
+			const FVector2D edge_end(polygon_verts[(i + 1) % polygon_verts.Num()]);
+
+			bool is_separating_edge = true;
+			for (const auto& box_corner : box_corners)
+			{
+				if (FVector2D::CrossProduct(edge_end - edge_start, box_corner - edge_start) * winding_sign > -KINDA_SMALL_NUMBER)
+				{
+					is_separating_edge = false;
+					break;
+				}
+			}
+
+			if (is_separating_edge)
+				return false;
+		}
+
+		return true;
+	}
+}
+
+FVEN_ReachabilityField::FVEN_ReachabilityField()
+	: m_grid_origin(FVector::ZeroVector)
+	, m_max_cost(0.f)
+	, m_cell_size(0.f)
+	, m_grid_size(0)
+{
+
+}
+
+void FVEN_ReachabilityField::Reset()
+{
+	m_nodes.Reset();
+	m_cells.Reset();
+	m_layers.Reset();
+	m_blockers.Reset();
+	m_grid_origin = FVector::ZeroVector;
+	m_max_cost = 0.f;
+	m_cell_size = 0.f;
+	m_grid_size = 0;
+}
+
+void FVEN_ReachabilityField::Setup(const FVector& origin, float max_cost, float cell_size, const TArray<FVEN_NavigationBlocker>& blockers)
+{
+	Reset();
+	m_blockers = blockers;
+
+	//nothing further than max cost can be reached, grid is a square around origin
+	m_max_cost = max_cost;
+	m_cell_size = cell_size;
+	m_grid_size = FMath::Max(1, FMath::CeilToInt(2.f * max_cost / cell_size) + 1);
+	m_grid_origin = origin - FVector(m_grid_size * cell_size * .5f, m_grid_size * cell_size * .5f, 0.f);
+	m_cells.Init(INDEX_NONE, m_grid_size * m_grid_size);
+}
+
+bool FVEN_ReachabilityField::IsValid() const
+{
+	return m_nodes.Num() > 0;
+}
+
+bool FVEN_ReachabilityField::GetMoveCost(const FVector& location, float& cost) const
+{
+	int32 x = 0;
+	int32 y = 0;
+	if (!GetCellCoords(location, x, y))
+		return false;
+
+	//level nearest to location in height
+	int32 node_index = INDEX_NONE;
+	float min_height_difference = LOOKUP_HEIGHT_TOLERANCE;
+	for (int32 layer_index = m_cells[y * m_grid_size + x]; layer_index != INDEX_NONE; layer_index = m_layers[layer_index].next_layer_index)
+	{
+		const auto& layer = m_layers[layer_index];
+		const float height_difference = location.Z < layer.min_z ? layer.min_z - location.Z : FMath::Max(location.Z - layer.max_z, 0.f);
+		if (height_difference <= min_height_difference)
+		{
+			min_height_difference = height_difference;
+			node_index = layer.node_index;
+		}
+	}
+
+	if (node_index == INDEX_NONE)
+		return false;
+
+	const auto& node = m_nodes[node_index];
+	const float location_cost = node.cost + GetSegmentCost(node.entry_point, location);
+	if (location_cost > m_max_cost)
+		return false;
+
+	cost = location_cost;
+	return true;
+}
+
+float FVEN_ReachabilityField::GetMaxCost() const
+{
+	return m_max_cost;
+}
+
+int32 FVEN_ReachabilityField::AddNode(const FVector& entry_point, float cost)
+{
+	return m_nodes.Add({ entry_point, cost });
+}
+
+void FVEN_ReachabilityField::UpdateNode(int32 node_index, const FVector& entry_point, float cost)
+{
+	m_nodes[node_index] = { entry_point, cost };
+}
+
+const FVector& FVEN_ReachabilityField::GetNodeEntryPoint(int32 node_index) const
+{
+	return m_nodes[node_index].entry_point;
+}
+
+float FVEN_ReachabilityField::GetNodeCost(int32 node_index) const
+{
+	return m_nodes[node_index].cost;
+}
+
+float FVEN_ReachabilityField::GetSegmentCost(const FVector& start, const FVector& end) const
+{
+	const float cost = FVector::Dist(start, end);
+	return m_blockers.Num() ? cost + UVEN_NavigationFilter::EstimateDetourLength(m_blockers, { start, end }) : cost;
+}
+
+void FVEN_ReachabilityField::RasterizeNode(int32 node_index, const TArray<FVector>& polygon_verts)
+{
+	if (!m_nodes.IsValidIndex(node_index) || polygon_verts.Num() < 3)
+		return;
+
+	//clamp polygon bounds to grid
+	const FBox polygon_bounds(polygon_verts);
+	const int32 min_x = FMath::Clamp(FMath::FloorToInt((polygon_bounds.Min.X - m_grid_origin.X) / m_cell_size), 0, m_grid_size - 1);
+	const int32 min_y = FMath::Clamp(FMath::FloorToInt((polygon_bounds.Min.Y - m_grid_origin.Y) / m_cell_size), 0, m_grid_size - 1);
+	const int32 max_x = FMath::Clamp(FMath::FloorToInt((polygon_bounds.Max.X - m_grid_origin.X) / m_cell_size), 0, m_grid_size - 1);
+	const int32 max_y = FMath::Clamp(FMath::FloorToInt((polygon_bounds.Max.Y - m_grid_origin.Y) / m_cell_size), 0, m_grid_size - 1);
+
+	for (int32 y = min_y; y <= max_y; ++y)
+	{
+		for (int32 x = min_x; x <= max_x; ++x)
+		{
+			const FVector2D cell_min(m_grid_origin.X + x * m_cell_size, m_grid_origin.Y + y * m_cell_size);
+			if (does_convex_polygon_overlap_box(polygon_verts, cell_min, cell_min + FVector2D(m_cell_size, m_cell_size)))
+				RasterizeCell(y * m_grid_size + x, node_index, polygon_bounds.Min.Z, polygon_bounds.Max.Z);
+		}
+	}
+}
+
+bool FVEN_ReachabilityField::GetCellCoords(const FVector& location, int32& x, int32& y) const
+{
+	if (!m_grid_size)
+		return false;
+
+	x = FMath::FloorToInt((location.X - m_grid_origin.X) / m_cell_size);
+	y = FMath::FloorToInt((location.Y - m_grid_origin.Y) / m_cell_size);
+	return x >= 0 && y >= 0 && x < m_grid_size && y < m_grid_size;
+}
+
+void FVEN_ReachabilityField::RasterizeCell(int32 cell_index, int32 node_index, float min_z, float max_z)
+{
+	for (int32 layer_index = m_cells[cell_index]; layer_index != INDEX_NONE; layer_index = m_layers[layer_index].next_layer_index)
+	{
+		auto& layer = m_layers[layer_index];
+		if (min_z > layer.max_z + LAYER_HEIGHT_TOLERANCE || max_z < layer.min_z - LAYER_HEIGHT_TOLERANCE)
+			continue;
+
+		//same level, cheaper node owns the cell
+		if (m_nodes[layer.node_index].cost > m_nodes[node_index].cost)
+			layer.node_index = node_index;
+
+		layer.min_z = FMath::Min(layer.min_z, min_z);
+		layer.max_z = FMath::Max(layer.max_z, max_z);
+		return;
+	}
+
+	m_cells[cell_index] = m_layers.Add({ node_index, min_z, max_z, m_cells[cell_index] });
+}
\ No newline at end of file
@@ -0,0 +1,209 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "VEN_SignificanceManager.h"
+#include "VEN_GameMode.h"
+#include "VEN_InteractableItem.h"
+#include "VEN_BattleSystem.h"
+#include "VEN_Stats.h"
+
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Character.h"
+#include "DrawDebugHelpers.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Significance Update"), STAT_VEN_SignificanceUpdate, STATGROUP_Vendetta);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Significance Critical Actors"), STAT_VEN_SignificanceCritical, STATGROUP_Vendetta);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Significance High Actors"), STAT_VEN_SignificanceHigh, STATGROUP_Vendetta);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Significance Medium Actors"), STAT_VEN_SignificanceMedium, STATGROUP_Vendetta);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Significance Low Actors"), STAT_VEN_SignificanceLow, STATGROUP_Vendetta);
+
+using namespace vendetta;
+
+namespace
+{
+	constexpr const float UPDATE_INTERVAL = .25f;
+	//covers enemy sensing radius, so sensing enemies always tick every frame
+	constexpr const float HIGH_SIGNIFICANCE_DISTANCE = 3500.f;
+	constexpr const float MEDIUM_SIGNIFICANCE_DISTANCE = 7000.f;
+
+	struct FSignificanceSettings
+	{
+		float tick_interval;
+		bool particles_are_active;
+	};
+
+	//animation rate is left to animation budget, it reads buckets from here
+	constexpr const FSignificanceSettings SIGNIFICANCE_SETTINGS[(int32)SIGNIFICANCE::COUNT] =
+	{
+		{ 0.f, true },
+		{ 0.f, true },
+		{ .1f, true },
+		{ .25f, false }
+	};
+
+	const TCHAR* SIGNIFICANCE_NAMES[(int32)SIGNIFICANCE::COUNT] = { TEXT("critical"), TEXT("high"), TEXT("medium"), TEXT("low") };
+	const FColor SIGNIFICANCE_COLORS[(int32)SIGNIFICANCE::COUNT] = { FColor::Red, FColor::Yellow, FColor::Green, FColor::Blue };
+
+	TAutoConsoleVariable<int32> CVAR_SHOW_SIGNIFICANCE(
+		TEXT("ven.ShowSignificance"),
+		0,
+		TEXT("Draw significance bucket over every actor handled by significance manager."),
+		ECVF_Cheat);
+}
+
+UVEN_SignificanceManager::UVEN_SignificanceManager()
+	: m_time_to_update(0.f)
+	, m_is_initialized(false)
+{
+
+}
+
+void UVEN_SignificanceManager::Initialize()
+{
+	Uninitialize();
+	m_is_initialized = true;
+
+	//items have no initialization of their own
+	for (TActorIterator<AVEN_InteractableItem> iterator(GetWorld()); iterator; ++iterator)
+		RegisterActor(*iterator);
+}
+
+void UVEN_SignificanceManager::Uninitialize()
+{
+	m_is_initialized = false;
+	m_actors.Empty();
+	m_significances.Empty();
+	m_time_to_update = 0.f;
+}
+
+void UVEN_SignificanceManager::RegisterActor(AActor* actor)
+{
+	if (!actor || m_actors.Contains(actor))
+		return;
+
+	//actors start fully updated, settings are applied on the first bucket change
+	m_actors.Add(actor);
+	m_significances.Add(SIGNIFICANCE::CRITICAL);
+}
+
+SIGNIFICANCE UVEN_SignificanceManager::GetSignificance(const AActor* actor) const
+{
+	const int32 index = m_actors.IndexOfByKey(actor);
+	return index != INDEX_NONE ? m_significances[index] : SIGNIFICANCE::CRITICAL;
+}
+
+void UVEN_SignificanceManager::Tick(float DeltaTime)
+{
+	m_time_to_update -= DeltaTime;
+	if (m_time_to_update > 0.f)
+		return;
+
+	m_time_to_update = UPDATE_INTERVAL;
+	UpdateSignificance();
+}
+
+bool UVEN_SignificanceManager::IsTickable() const
+{
+	return m_is_initialized;
+}
+
+TStatId UVEN_SignificanceManager::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UVEN_SignificanceManager, STATGROUP_Tickables);
+}
+
+AVEN_GameMode* UVEN_SignificanceManager::GetGameMode() const
+{
+	const auto& world = GetWorld();
+	const auto& game_mode = world ? Cast<AVEN_GameMode>(world->GetAuthGameMode()) : nullptr;
+	//if (!game_mode)
+		//debug_log("UVEN_SignificanceManager::GetGameMode. Game Mode not found!", FColor::Red);
+
+	return game_mode;
+}
+
+void UVEN_SignificanceManager::UpdateSignificance()
+{
+	SCOPE_CYCLE_COUNTER(STAT_VEN_SignificanceUpdate);
+
+	const auto& game_mode = GetGameMode();
+	if (!game_mode)
+		return;
+
+	TArray<FVector> focus_locations;
+	if (game_mode->GetMainCameraRoot())
+		focus_locations.Add(game_mode->GetMainCameraRoot()->GetComponentLocation());
+	for (const auto& player_unit : game_mode->GetPlayerUnits())
+	{
+		if (player_unit)
+			focus_locations.Add(player_unit->GetActorLocation());
+	}
+
+	int32 counts[(int32)SIGNIFICANCE::COUNT] = {};
+	const bool show_significance = CVAR_SHOW_SIGNIFICANCE.GetValueOnGameThread() != 0;
+
+	for (int32 i = m_actors.Num() - 1; i >= 0; --i)
+	{
+		const auto& actor = m_actors[i];
+		if (!IsValid(actor))
+		{
+			m_actors.RemoveAtSwap(i);
+			m_significances.RemoveAtSwap(i);
+			continue;
+		}
+
+		const SIGNIFICANCE significance = CalculateSignificance(actor, focus_locations);
+		if (significance != m_significances[i])
+		{
+			ApplySignificance(actor, significance);
+			m_significances[i] = significance;
+		}
+
+		counts[(int32)significance]++;
+
+		if (show_significance)
+			DrawDebugString(GetWorld(), actor->GetActorLocation() + FVector(0.f, 0.f, 120.f), SIGNIFICANCE_NAMES[(int32)significance], nullptr, SIGNIFICANCE_COLORS[(int32)significance], UPDATE_INTERVAL);
+	}
+
+	SET_DWORD_STAT(STAT_VEN_SignificanceCritical, counts[(int32)SIGNIFICANCE::CRITICAL]);
+	SET_DWORD_STAT(STAT_VEN_SignificanceHigh, counts[(int32)SIGNIFICANCE::HIGH]);
+	SET_DWORD_STAT(STAT_VEN_SignificanceMedium, counts[(int32)SIGNIFICANCE::MEDIUM]);
+	SET_DWORD_STAT(STAT_VEN_SignificanceLow, counts[(int32)SIGNIFICANCE::LOW]);
+}
+
+SIGNIFICANCE UVEN_SignificanceManager::CalculateSignificance(const AActor* actor, const TArray<FVector>& focus_locations) const
+{
+	const auto& battle_system = GetGameMode()->GetBattleSystem();
+	if (battle_system && battle_system->IsInBattle(actor))
+		return SIGNIFICANCE::CRITICAL;
+
+	//movement integrates frame delta time, it cannot be throttled
+	if (!actor->GetVelocity().IsNearlyZero())
+		return SIGNIFICANCE::CRITICAL;
+
+	float min_distance_squared = MAX_flt;
+	for (const auto& focus_location : focus_locations)
+		min_distance_squared = FMath::Min(min_distance_squared, FVector::DistSquared(actor->GetActorLocation(), focus_location));
+
+	if (min_distance_squared < FMath::Square(HIGH_SIGNIFICANCE_DISTANCE))
+		return SIGNIFICANCE::HIGH;
+	if (min_distance_squared < FMath::Square(MEDIUM_SIGNIFICANCE_DISTANCE))
+		return SIGNIFICANCE::MEDIUM;
+
+	return SIGNIFICANCE::LOW;
+}
+
+void UVEN_SignificanceManager::ApplySignificance(AActor* actor, SIGNIFICANCE significance)
+{
+	const auto& settings = SIGNIFICANCE_SETTINGS[(int32)significance];
+
+	//units switch their tick on and off by themselves, only the rate is set here
+	if (Cast<ACharacter>(actor))
+		actor->SetActorTickInterval(settings.tick_interval);
+
+	const auto& interactable_item = Cast<AVEN_InteractableItem>(actor);
+	if (interactable_item)
+		interactable_item->ActivateParticleSystem(settings.particles_are_active);
+}
\ No newline at end of file
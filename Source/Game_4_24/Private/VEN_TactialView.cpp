@@ -6,7 +6,13 @@
 #include "VEN_EnemyUnit.h"
 #include "VEN_InteractableNPC.h"
 #include "VEN_BattleSystem.h"
+#include "VEN_GameMode.h"
+#include "VEN_NavigationFilter.h"
+#include "VEN_PathPreview.h"
+#include "VEN_RangeOverlay.h"
+#include "VEN_InteractionPoint.h"
 #include "VEN_FreeFunctions.h"
+#include "VEN_Stats.h"
 
 #include "Engine/World.h"
 #include "Engine/Engine.h"
@@ -14,41 +20,47 @@
 #include "NavigationPath.h"
 #include "Components/SplineComponent.h"
 #include "Components/CapsuleComponent.h"
-#include "Components/DecalComponent.h"
-#include "Materials/MaterialInstance.h"
-#include "UObject/ConstructorHelpers.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Tactical View Rebuilds"), STAT_VEN_TacticalViewRebuilds, STATGROUP_Vendetta);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Tactical View Hover Updates"), STAT_VEN_TacticalViewHoverUpdates, STATGROUP_Vendetta);
 
 using namespace vendetta;
 
+namespace
+{
+	constexpr const float HOVERED_CELL_SIZE = 50.f;
+	constexpr const float OWNER_LOCATION_TOLERANCE = 1.f;
+}
+
 UVEN_TactialView::UVEN_TactialView()
 	: m_owner(nullptr)
 	, m_hovered_actor(nullptr)
 	, m_battle_system(nullptr)
-	, m_movement_spline_actor(nullptr)
+	, m_movement_path(nullptr)
 	, m_movement_spline_component(nullptr)
-	, m_main_area_decal_actor(nullptr)
-	, m_minor_area_decal_actors({})
-	, m_main_area_decal_material_bow(nullptr)
-	, m_main_area_decal_material_sword(nullptr)
-	, m_main_area_decal_material_minor(nullptr)
+	, m_range_overlay(nullptr)
 	, m_is_allowed(false)
 	, m_movement_spline_is_built(false)
 	, m_hovered_location(FVector::ZeroVector)
+	, m_enemy_units_info_is_valid(false)
+	, m_enemy_units_info_revision(0)
+	, m_enemy_units_info_owner_location(FVector::ZeroVector)
+	, m_hovered_cell(FIntVector::ZeroValue)
+	, m_hovered_cell_is_valid(false)
 {
-	static ConstructorHelpers::FObjectFinder<UMaterialInstance> TacticalViewDecalMaterialBow(TEXT("MaterialInstance'/Game/Materials/TacticalView/MI_TacticalViewMainBow.MI_TacticalViewMainBow'"));
-	m_main_area_decal_material_bow = TacticalViewDecalMaterialBow.Object;
-	static ConstructorHelpers::FObjectFinder<UMaterialInstance> TacticalViewDecalMaterialSword(TEXT("MaterialInstance'/Game/Materials/TacticalView/MI_TacticalViewMainSword.MI_TacticalViewMainSword'"));
-	m_main_area_decal_material_sword = TacticalViewDecalMaterialSword.Object;
-	static ConstructorHelpers::FObjectFinder<UMaterialInstance> TacticalViewDecalMaterialMinor(TEXT("MaterialInstance'/Game/Materials/TacticalView/MI_TacticalViewMinor.MI_TacticalViewMinor'"));
-	m_main_area_decal_material_minor = TacticalViewDecalMaterialMinor.Object;
+
 }
 
 void UVEN_TactialView::Initialize(AVEN_PlayerUnit* owner, UVEN_BattleSystem* battle_system)
 {
 	m_owner = owner;
 	m_battle_system = battle_system;
-	m_enemy_units_info.Empty();
-	m_minor_area_decal_actors.Empty();
+	InvalidateEnemyUnitsInfo();
+}
+
+UVEN_BattleInstance* UVEN_TactialView::GetBattle() const
+{
+	return m_battle_system ? m_battle_system->GetBattle(m_owner) : nullptr;
 }
 
 void UVEN_TactialView::OnRequestData(bool is_allowed, AActor* hovered_actor, FVector hovered_location)
@@ -57,34 +69,66 @@ void UVEN_TactialView::OnRequestData(bool is_allowed, AActor* hovered_actor, FVe
 	m_hovered_actor = hovered_actor;
 	m_hovered_location = hovered_location;
 
-	UpdateDecals();
+	UpdateRangeOverlay();
 
-	if (m_is_allowed)
+	if (!m_is_allowed)
 	{
+		InvalidateEnemyUnitsInfo();
+		return;
+	}
+
+	const bool rebuild_is_needed = !IsEnemyUnitsInfoValid();
+	if (rebuild_is_needed)
 		GatherEnemyUnitsRelatedInfo();
+
+	//blueprint is notified only when something it shows has changed
+	if (UpdateHoverRelatedInfo(rebuild_is_needed) || rebuild_is_needed)
 		NotifyOwner();
-	}
 }
 
-void UVEN_TactialView::GatherEnemyUnitsRelatedInfo()
+bool UVEN_TactialView::IsEnemyUnitsInfoValid() const
+{
+	const auto& battle = GetBattle();
+	if (!m_enemy_units_info_is_valid || !battle)
+		return false;
+
+	if (m_enemy_units_info_revision != battle->GetBattleStateRevision())
+		return false;
+
+	return FVector::PointsAreNear(m_enemy_units_info_owner_location, m_owner->GetActorLocation(), OWNER_LOCATION_TOLERANCE);
+}
+
+void UVEN_TactialView::InvalidateEnemyUnitsInfo()
 {
 	m_enemy_units_info.Empty();
+	m_enemy_units.Empty();
+	m_enemy_units_info_is_valid = false;
+	m_hovered_cell_is_valid = false;
+}
 
-	if (!m_battle_system || !m_battle_system->IsBattleInProgress())
+void UVEN_TactialView::GatherEnemyUnitsRelatedInfo()
+{
+	InvalidateEnemyUnitsInfo();
+
+	const auto& battle = GetBattle();
+	if (!battle || !battle->IsBattleInProgress())
 	{
 		//debug_log("UVEN_TactialView::GatherEnemyUnitsRelatedInfo. Battle System is corrupted", FColor::Red);
 		return;
 	}
 
 	//gather alive enemy in battle
-	TArray<AActor*> enemy_units_raw = m_battle_system->GetEnemyUnitsInBattle();
+	const auto& enemy_units_raw = battle->GetEnemyUnitsInBattle();
 	TArray<AVEN_EnemyUnit*> enemy_units;
 
 	for (const auto& enemy_unit_raw : enemy_units_raw)
 		enemy_units.Add(Cast<AVEN_EnemyUnit>(enemy_unit_raw));
 
-	if (!enemy_units.Num())
-		return;
+	INC_DWORD_STAT(STAT_VEN_TacticalViewRebuilds);
+
+	m_enemy_units_info_is_valid = true;
+	m_enemy_units_info_revision = battle->GetBattleStateRevision();
+	m_enemy_units_info_owner_location = m_owner->GetActorLocation();
 
 	for (const auto& enemy_unit : enemy_units)
 	{
@@ -97,14 +141,15 @@ void UVEN_TactialView::GatherEnemyUnitsRelatedInfo()
 		if (enemy_unit->IsDead())
 			continue;
 
+		m_enemy_units.Add(enemy_unit);
 		m_enemy_units_info.Add({});
 		auto& info = m_enemy_units_info[m_enemy_units_info.Num() - 1];
 
 		info.location = enemy_unit->GetActorLocation();
 		info.type = enemy_unit->GetUnitType();
-		info.is_hovered = m_hovered_actor == enemy_unit;
+		info.is_hovered = false;
 		info.in_main_area = CanActorBeAttackedFromPoint(enemy_unit, m_owner->GetActorLocation());
-		info.in_minor_area = CanActorBeAttackedFromPoint(enemy_unit, m_hovered_location + m_owner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight());
+		info.in_minor_area = false;
 		info.hp_current = enemy_unit->GetHP();
 		info.hp_total = enemy_unit->GetTotalHP();
 		info.attack_power_min = enemy_unit->GetAttackPowerMin();
@@ -116,128 +161,81 @@ void UVEN_TactialView::GatherEnemyUnitsRelatedInfo()
 	}
 }
 
-void UVEN_TactialView::UpdateDecals()
+bool UVEN_TactialView::UpdateHoverRelatedInfo(bool force_update)
 {
-	if (!m_is_allowed)
-	{
-		if (m_main_area_decal_actor)
-		{
-			m_main_area_decal_actor->Destroy();
-		}
-		if (m_minor_area_decal_actors.Num())
-		{
-			for (const auto& actor : m_minor_area_decal_actors)
-				actor->Destroy();
-		}
+	bool is_changed = false;
 
-		m_main_area_decal_actor = nullptr;
-		m_minor_area_decal_actors = {};
-
-		return;
-	}
-
-	const float DECAL_DEPTH = 500.f;
-	const float DECAL_HEIGHT_OFFSET = 450.f;
-	const float DECAL_DIAMETER_OWNER = m_owner->GetAttackRange() * 2;
-	FVector owner_location = m_owner->GetActorLocation();
-	FVector decal_actor_location = FVector(owner_location.X, owner_location.Y, (owner_location.Z - m_owner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight() - DECAL_HEIGHT_OFFSET));
-
-	//update main decal
-	if (!m_main_area_decal_actor)
+	for (int i = 0; i < m_enemy_units_info.Num(); ++i)
 	{
-		const auto& owner_attack_type = m_owner->GetAttackType();
-		UMaterialInstance* main_material = nullptr;
-		if (owner_attack_type == ATTACK_TYPE::MELEE)
-			main_material = m_main_area_decal_material_sword;
-		else if (owner_attack_type == ATTACK_TYPE::RANGE)
-			main_material = m_main_area_decal_material_bow;
-
-		if (!main_material)
-			return;
+		const bool is_hovered = m_hovered_actor && m_hovered_actor == m_enemy_units[i].Get();
+		is_changed |= m_enemy_units_info[i].is_hovered != is_hovered;
+		m_enemy_units_info[i].is_hovered = is_hovered;
+	}
 
-		FActorSpawnParameters spawn_params;
-		m_main_area_decal_actor = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), decal_actor_location, FRotator::ZeroRotator, spawn_params);
+	const FIntVector hovered_cell(FMath::FloorToInt(m_hovered_location.X / HOVERED_CELL_SIZE), FMath::FloorToInt(m_hovered_location.Y / HOVERED_CELL_SIZE), FMath::FloorToInt(m_hovered_location.Z / HOVERED_CELL_SIZE));
+	if (!force_update && m_hovered_cell_is_valid && m_hovered_cell == hovered_cell)
+		return is_changed;
 
-		if (!m_main_area_decal_actor)
-			return;
+	INC_DWORD_STAT(STAT_VEN_TacticalViewHoverUpdates);
 
-		UDecalComponent* decal = NewObject<UDecalComponent>(m_main_area_decal_actor, "Tactical View Main Decal");
-		if (decal)
-		{
-			decal->RegisterComponent();
-			decal->SetMaterial(0, main_material);
-			decal->SetRelativeRotation(FRotator(-90.f, 0.f, 0.f));
-			decal->DecalSize = FVector(DECAL_DEPTH, DECAL_DIAMETER_OWNER, DECAL_DIAMETER_OWNER);
-		}
+	m_hovered_cell = hovered_cell;
+	m_hovered_cell_is_valid = true;
 
-		m_main_area_decal_actor->SetRootComponent(decal);
-		m_main_area_decal_actor->SetActorEnableCollision(false);
+	const FVector minor_area_point = m_hovered_location + m_owner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+	for (int i = 0; i < m_enemy_units_info.Num(); ++i)
+	{
+		const auto& enemy_unit = m_enemy_units[i].Get();
+		const bool in_minor_area = enemy_unit && CanActorBeAttackedFromPoint(enemy_unit, minor_area_point);
+		is_changed |= m_enemy_units_info[i].in_minor_area != in_minor_area;
+		m_enemy_units_info[i].in_minor_area = in_minor_area;
 	}
 
-	if (m_main_area_decal_actor)
-		m_main_area_decal_actor->SetActorLocation(decal_actor_location);
-
-	/*
-		implement for minor area decal actor if needed
-	*/
+	return is_changed;
+}
 
-	//enemy units decals
-	TArray<AActor*> enemy_units_raw = m_battle_system->GetEnemyUnitsInBattle();
-	TArray<AVEN_EnemyUnit*> enemy_units;
-	for (const auto& enemy_unit_raw : enemy_units_raw)
+void UVEN_TactialView::UpdateRangeOverlay()
+{
+	if (!m_is_allowed)
 	{
-		const auto& enemy_unit_c = Cast<AVEN_EnemyUnit>(enemy_unit_raw);
-		if (enemy_unit_c && !enemy_unit_c->IsDead())
-			enemy_units.Add(enemy_unit_c);
+		if (m_range_overlay)
+			m_range_overlay->Hide();
+
+		return;
 	}
 
-	if (m_minor_area_decal_actors.Num() != enemy_units.Num())
+	if (!m_range_overlay)
 	{
-		for (const auto& actor : m_minor_area_decal_actors)
-			actor->Destroy();
-		m_minor_area_decal_actors = {};
-
+		FActorSpawnParameters spawn_params;
+		spawn_params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		m_range_overlay = GetWorld()->SpawnActor<AVEN_RangeOverlay>(AVEN_RangeOverlay::StaticClass(), m_owner->GetActorLocation(), FRotator::ZeroRotator, spawn_params);
 
-		for (int i = 0; i < enemy_units.Num(); ++i)
+		if (!m_range_overlay)
 		{
-			const float DECAL_DIAMETER_ENEMY = enemy_units[i]->GetAttackRange() * 2;
-			owner_location = enemy_units[i]->GetActorLocation();
-			decal_actor_location = FVector(owner_location.X, owner_location.Y, (owner_location.Z - enemy_units[i]->GetCapsuleComponent()->GetScaledCapsuleHalfHeight() - DECAL_HEIGHT_OFFSET));
-
-			if (!m_main_area_decal_material_minor)
-				return;
-
-			FActorSpawnParameters spawn_params_minor;
-			auto enemy_decal_actor = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), decal_actor_location, FRotator::ZeroRotator, spawn_params_minor);
-			if (!enemy_decal_actor)
-				return;
-
-			UDecalComponent* decal = NewObject<UDecalComponent>(enemy_decal_actor, "Tactical View Minor Decal");
-			if (decal)
-			{
-				decal->RegisterComponent();
-				decal->SetMaterial(0, m_main_area_decal_material_minor);
-				decal->SetRelativeRotation(FRotator(-90.f, 0.f, 0.f));
-				decal->DecalSize = FVector(DECAL_DEPTH, DECAL_DIAMETER_ENEMY, DECAL_DIAMETER_ENEMY);
-			}
-
-			enemy_decal_actor->SetRootComponent(decal);
-			enemy_decal_actor->SetActorEnableCollision(false);
-
-			m_minor_area_decal_actors.Add(enemy_decal_actor);
+			//debug_log("UVEN_TactialView::UpdateRangeOverlay. Cannot spawn range overlay", FColor::Red);
+			return;
 		}
 	}
 
-	if (m_minor_area_decal_actors.Num() == enemy_units.Num())
+	//owner circle goes first and keeps the first pooled decal
+	TArray<FVEN_RangeCircle> circles;
+	const auto& owner_attack_type = m_owner->GetAttackType();
+	if (owner_attack_type != ATTACK_TYPE::NONE)
 	{
-		for (int i = 0; i < enemy_units.Num(); ++i)
-		{
-			owner_location = enemy_units[i]->GetActorLocation();
-			decal_actor_location = FVector(owner_location.X, owner_location.Y, (owner_location.Z - enemy_units[i]->GetCapsuleComponent()->GetScaledCapsuleHalfHeight() - DECAL_HEIGHT_OFFSET));
+		const auto circle_type = owner_attack_type == ATTACK_TYPE::MELEE ? RANGE_CIRCLE_TYPE::OWNER_MELEE : RANGE_CIRCLE_TYPE::OWNER_RANGE;
+		circles.Add({ FVector2D(m_owner->GetActorLocation()), (float)m_owner->GetAttackRange(), circle_type });
+	}
 
-			m_minor_area_decal_actors[i]->SetActorLocation(decal_actor_location);
-		}
+	//enemy units circles
+	const auto& battle = GetBattle();
+	for (const auto& enemy_unit_raw : battle ? battle->GetEnemyUnitsInBattle() : TArray<AActor*>())
+	{
+		const auto& enemy_unit_c = Cast<AVEN_EnemyUnit>(enemy_unit_raw);
+		if (enemy_unit_c && !enemy_unit_c->IsDead())
+			circles.Add({ FVector2D(enemy_unit_c->GetActorLocation()), (float)enemy_unit_c->GetAttackRange(), RANGE_CIRCLE_TYPE::ENEMY });
 	}
+
+	const float ground_z = m_owner->GetActorLocation().Z - m_owner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+	m_range_overlay->SetCircles(circles, ground_z);
 }
 
 void UVEN_TactialView::NotifyOwner()
@@ -260,28 +258,17 @@ bool UVEN_TactialView::IsHoveredUnit()
 
 bool UVEN_TactialView::CanActorBeAttackedFromPoint(AActor* actor, FVector point) const
 {
-	FHitResult trace_hit_result;
-	FVector trace_start_point = point;
-	FVector trace_end_point = actor->GetActorLocation();
-	FCollisionQueryParams trace_params;
-	trace_params.AddIgnoredActor(m_owner);
+	if (m_owner->GetAttackRange() < calculate_distance(point, actor->GetActorLocation(), true))
+		return false;
 
-	bool no_obstacles_on_attack_trace = true;
-	bool valid_attack_range = true;
-
-	if (m_owner->GetAttackRange() < calculate_distance(trace_start_point, trace_end_point, true))
-		valid_attack_range = false;
-
-	if (GetWorld()->LineTraceSingleByChannel(trace_hit_result, trace_start_point, trace_end_point, ECC_Visibility, trace_params))
+	const auto& game_mode = Cast<AVEN_GameMode>(GetWorld()->GetAuthGameMode());
+	if (!game_mode || !game_mode->GetVisibilityService())
 	{
-		if (trace_hit_result.GetActor() != actor)
-			no_obstacles_on_attack_trace = false;
+		//debug_log("UVEN_TactialView::CanActorBeAttackedFromPoint. Visibility Service not found!", FColor::Red);
+		return false;
 	}
 
-	if (valid_attack_range && no_obstacles_on_attack_trace)
-		return true;
-
-	return false;
+	return game_mode->GetVisibilityService()->IsVisible(m_owner, actor, point);
 }
 
 float UVEN_TactialView::GetOwnerMovementPriceToAttackPoint(AActor* actor)
@@ -295,6 +282,15 @@ float UVEN_TactialView::GetOwnerMovementPriceToAttackPoint(AActor* actor)
 
 	BuildMovementSpline(target_location);
 	FVector interaction_point_location = GetAttackPointLocation(actor);
+
+	//within turn budget the price is a lookup in owner's reachability field, points beyond it are priced by path
+	const auto& reachability_field = m_owner->GetReachabilityField();
+	if (reachability_field.IsValid() && interaction_point_location != FVector::ZeroVector && reachability_field.GetMoveCost(interaction_point_location, movement_price))
+	{
+		DestroyMovementSpline();
+		return movement_price;
+	}
+
 	BuildMovementSpline(interaction_point_location);
 
 	if (m_movement_spline_is_built)
@@ -316,74 +312,43 @@ void UVEN_TactialView::BuildMovementSpline(FVector destination_point)
 	FVector start_movement_point = m_owner->GetCapsuleComponent()->GetComponentLocation();
 	start_movement_point.Z -= half_capsule_height;
 
-	UNavigationPath* movement_path = UNavigationSystemV1::FindPathToLocationSynchronously(GetWorld(), start_movement_point, destination_point, m_owner);
-	m_movement_spline_is_built = (movement_path->PathPoints.Num() > 0);
+	UNavigationPath* movement_path = UNavigationSystemV1::FindPathToLocationSynchronously(GetWorld(), start_movement_point, destination_point, m_owner, UVEN_NavigationFilter::StaticClass());
+	m_movement_spline_is_built = UVEN_NavigationFilter::AvoidBlockers(m_owner, movement_path->PathPoints) && movement_path->PathPoints.Num() > 0;
 
 	if (!m_movement_spline_is_built)
 		return;
 
-	//create temporary spline based on path
-	FActorSpawnParameters spawn_params;
-	m_movement_spline_actor = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), start_movement_point, FRotator::ZeroRotator, spawn_params);
-	m_movement_spline_component = NewObject<USplineComponent>(m_movement_spline_actor, "Movement Spline");
-	m_movement_spline_component->RegisterComponent();
-	m_movement_spline_component->RemoveSplinePoint(1);
-
-	if (!m_movement_spline_component)
-		return;
+	//spline is reused between hovered enemy units, it is never shown
+	if (!m_movement_path)
+	{
+		FActorSpawnParameters spawn_params;
+		m_movement_path = GetWorld()->SpawnActor<AVEN_PathPreview>(AVEN_PathPreview::StaticClass(), start_movement_point, FRotator::ZeroRotator, spawn_params);
 
-	m_movement_spline_actor->SetRootComponent(m_movement_spline_component);
-	m_movement_spline_actor->SetActorLocation(start_movement_point);
+		if (!m_movement_path)
+		{
+			m_movement_spline_is_built = false;
+			return;
+		}
 
-	//setup created spline with points
-	for (int i = 1; i < movement_path->PathPoints.Num(); ++i)
-	{
-		m_movement_spline_component->AddSplinePoint(movement_path->PathPoints[i], ESplineCoordinateSpace::World);
-		m_movement_spline_component->SetSplinePointType(i, ESplinePointType::CurveClamped);
+		m_movement_spline_component = m_movement_path->GetSpline();
 	}
+
+	m_movement_path->SetPath(start_movement_point, movement_path->PathPoints);
 }
 
 void UVEN_TactialView::DestroyMovementSpline()
 {
 	m_movement_spline_is_built = false;
 
-	if (m_movement_spline_actor)
-		m_movement_spline_actor->Destroy();
-
-	m_movement_spline_actor = nullptr;
-	m_movement_spline_component = nullptr;
+	if (m_movement_path)
+		m_movement_path->Clear();
 }
 
 FVector UVEN_TactialView::GetAttackPointLocation(AActor* actor) const
 {
-	if (!m_movement_spline_component)
+	if (!m_movement_spline_is_built)
 		return FVector::ZeroVector;
 
-	const FVector target_location = actor->GetActorLocation();
-	const int CHECKPOINTS_FREQUENCY_FACTOR = 50;
-	const int CHECKPOINTS_COUNT = (int)(m_movement_spline_component->GetSplineLength() / CHECKPOINTS_FREQUENCY_FACTOR);
-
-	for (int i = 0; i < CHECKPOINTS_COUNT; ++i)
-	{
-		const float time_at_current_checkpoint = (m_movement_spline_component->Duration / CHECKPOINTS_COUNT) * i;
-		FVector checkpoint_location = m_movement_spline_component->GetLocationAtTime(time_at_current_checkpoint, ESplineCoordinateSpace::World);
-		checkpoint_location.Z += m_owner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
-
-		//target is too far from current checkpoint
-		if (calculate_distance(checkpoint_location, target_location, true) > m_owner->GetAttackRange())
-			continue;
-
-		//trace if is interation range
-		FHitResult trace_hit_result;
-		FCollisionQueryParams trace_params;
-		trace_params.AddIgnoredActor(m_owner);
-
-		if (GetWorld()->LineTraceSingleByChannel(trace_hit_result, checkpoint_location, target_location, ECC_Visibility, trace_params))
-		{
-			if (trace_hit_result.GetActor() == actor)
-				return checkpoint_location;
-		}
-	}
-
-	return FVector::ZeroVector;
+	const float height_offset = m_owner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+	return find_interaction_point(m_movement_spline_component, m_owner, actor, m_owner->GetAttackRange(), height_offset, GetBattle() ? GetBattle()->GetLineOfSightGrid() : nullptr);
 }
\ No newline at end of file
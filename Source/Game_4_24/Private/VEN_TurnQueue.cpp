@@ -0,0 +1,98 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "VEN_TurnQueue.h"
+
+FVEN_TurnQueue::FVEN_TurnQueue()
+	: m_head(INDEX_NONE)
+	, m_count(0)
+{
+
+}
+
+void FVEN_TurnQueue::Reset(int32 capacity)
+{
+	m_next.Empty(capacity);
+	m_previous.Empty(capacity);
+	m_contains.Empty(capacity);
+	m_head = INDEX_NONE;
+	m_count = 0;
+}
+
+void FVEN_TurnQueue::Add(int32 handle)
+{
+	if (handle < 0 || Contains(handle))
+		return;
+
+	if (handle >= m_next.Num())
+	{
+		m_next.SetNum(handle + 1);
+		m_previous.SetNum(handle + 1);
+		m_contains.Add(false, handle + 1 - m_contains.Num());
+	}
+
+	m_contains[handle] = true;
+	m_count++;
+
+	if (m_head == INDEX_NONE)
+	{
+		m_head = handle;
+		m_next[handle] = handle;
+		m_previous[handle] = handle;
+		return;
+	}
+
+	const int32 tail = m_previous[m_head];
+	m_next[tail] = handle;
+	m_previous[handle] = tail;
+	m_next[handle] = m_head;
+	m_previous[m_head] = handle;
+}
+
+void FVEN_TurnQueue::Remove(int32 handle)
+{
+	if (!Contains(handle))
+		return;
+
+	m_contains[handle] = false;
+	m_count--;
+
+	if (!m_count)
+	{
+		m_head = INDEX_NONE;
+		return;
+	}
+
+	m_next[m_previous[handle]] = m_next[handle];
+	m_previous[m_next[handle]] = m_previous[handle];
+
+	//turn goes to the next participant like it was shifted to the front
+	if (m_head == handle)
+		m_head = m_next[handle];
+}
+
+void FVEN_TurnQueue::Advance()
+{
+	if (m_head != INDEX_NONE)
+		m_head = m_next[m_head];
+}
+
+bool FVEN_TurnQueue::Contains(int32 handle) const
+{
+	return handle >= 0 && handle < m_contains.Num() && m_contains[handle];
+}
+
+int32 FVEN_TurnQueue::GetHead() const
+{
+	return m_head;
+}
+
+int32 FVEN_TurnQueue::GetNext(int32 handle) const
+{
+	return Contains(handle) ? m_next[handle] : INDEX_NONE;
+}
+
+int32 FVEN_TurnQueue::Num() const
+{
+	return m_count;
+}
\ No newline at end of file
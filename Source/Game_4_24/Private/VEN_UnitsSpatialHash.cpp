@@ -0,0 +1,123 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "VEN_UnitsSpatialHash.h"
+#include "VEN_Stats.h"
+
+#include "GameFramework/Actor.h"
+
+DECLARE_CYCLE_STAT(TEXT("Units Spatial Hash Query"), STAT_VEN_UnitsSpatialHashQuery, STATGROUP_Vendetta);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Units Spatial Hash Cell Changes"), STAT_VEN_UnitsSpatialHashCellChanges, STATGROUP_Vendetta);
+
+namespace
+{
+	//small enough that battle gathering radius touches a few dozens of cells, big enough that walking units rarely change cell
+	constexpr const float CELL_SIZE = 1000.f;
+}
+
+UVEN_UnitsSpatialHash::UVEN_UnitsSpatialHash()
+{
+
+}
+
+void UVEN_UnitsSpatialHash::Initialize()
+{
+	Uninitialize();
+}
+
+void UVEN_UnitsSpatialHash::Uninitialize()
+{
+	m_units.Empty();
+	m_units_cells.Empty();
+	m_cells.Empty();
+}
+
+void UVEN_UnitsSpatialHash::RegisterUnit(AActor* unit)
+{
+	if (!unit)
+		return;
+
+	if (!m_units.Contains(unit))
+		m_units.Add(unit);
+
+	UpdateUnitLocation(unit);
+}
+
+void UVEN_UnitsSpatialHash::UnregisterUnit(AActor* unit)
+{
+	const auto cell = m_units_cells.Find(unit);
+	if (cell)
+		RemoveFromCell(unit, *cell);
+
+	m_units_cells.Remove(unit);
+	m_units.Remove(unit);
+}
+
+void UVEN_UnitsSpatialHash::UpdateUnitLocation(AActor* unit)
+{
+	if (!unit)
+		return;
+
+	const FIntPoint new_cell = GetCell(unit->GetActorLocation());
+	const auto old_cell = m_units_cells.Find(unit);
+	if (old_cell)
+	{
+		if (*old_cell == new_cell)
+			return;
+
+		RemoveFromCell(unit, *old_cell);
+		INC_DWORD_STAT(STAT_VEN_UnitsSpatialHashCellChanges);
+	}
+	else if (!m_units.Contains(unit))
+	{
+		//debug_log("UVEN_UnitsSpatialHash::UpdateUnitLocation. Unit is not registered", FColor::Red);
+		return;
+	}
+
+	m_units_cells.Add(unit, new_cell);
+	m_cells.FindOrAdd(new_cell).Add(unit);
+}
+
+void UVEN_UnitsSpatialHash::GatherUnits(const FVector& center, float radius, TArray<AActor*>& units, const UClass* unit_class, const AActor* unit_to_ignore) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_VEN_UnitsSpatialHashQuery);
+
+	const FIntPoint min_cell = GetCell(center - FVector(radius));
+	const FIntPoint max_cell = GetCell(center + FVector(radius));
+	const float radius_squared = FMath::Square(radius);
+
+	for (int32 x = min_cell.X; x <= max_cell.X; ++x)
+	{
+		for (int32 y = min_cell.Y; y <= max_cell.Y; ++y)
+		{
+			const auto cell_units = m_cells.Find(FIntPoint(x, y));
+			if (!cell_units)
+				continue;
+
+			for (const auto& unit : *cell_units)
+			{
+				if (!IsValid(unit) || unit == unit_to_ignore || (unit_class && !unit->IsA(unit_class)))
+					continue;
+
+				if (FVector::DistSquared(unit->GetActorLocation(), center) <= radius_squared)
+					units.Add(unit);
+			}
+		}
+	}
+}
+
+FIntPoint UVEN_UnitsSpatialHash::GetCell(const FVector& location) const
+{
+	return FIntPoint(FMath::FloorToInt(location.X / CELL_SIZE), FMath::FloorToInt(location.Y / CELL_SIZE));
+}
+
+void UVEN_UnitsSpatialHash::RemoveFromCell(AActor* unit, const FIntPoint& cell)
+{
+	auto cell_units = m_cells.Find(cell);
+	if (!cell_units)
+		return;
+
+	cell_units->RemoveSwap(unit);
+	if (!cell_units->Num())
+		m_cells.Remove(cell);
+}
\ No newline at end of file
@@ -0,0 +1,211 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "VEN_VisibilityService.h"
+#include "VEN_LineOfSightGrid.h"
+#include "VEN_GameMode.h"
+#include "VEN_BattleSystem.h"
+#include "VEN_BattleInstance.h"
+#include "VEN_Stats.h"
+
+#include "GameFramework/Actor.h"
+#include "CollisionQueryParams.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Visibility Cache Hits"), STAT_VEN_VisibilityCacheHits, STATGROUP_Vendetta);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Visibility Async Traces"), STAT_VEN_VisibilityAsyncTraces, STATGROUP_Vendetta);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Visibility Sync Traces"), STAT_VEN_VisibilitySyncTraces, STATGROUP_Vendetta);
+
+namespace
+{
+	constexpr const float POSITION_BUCKET_SIZE = 25.f;
+	constexpr const uint64 MAX_RESULT_AGE_IN_FRAMES = 10;
+	constexpr const int32 MAX_CACHED_ENTRIES = 1024;
+}
+
+UVEN_VisibilityService::UVEN_VisibilityService()
+	: m_last_trace_id(0)
+{
+
+}
+
+void UVEN_VisibilityService::Initialize()
+{
+	Uninitialize();
+	m_trace_delegate.BindUObject(this, &UVEN_VisibilityService::OnAsyncTraceCompleted);
+}
+
+void UVEN_VisibilityService::Uninitialize()
+{
+	//callbacks of pending traces are dropped, late trace results find no entries
+	m_entries.Empty();
+	m_pending_traces.Empty();
+}
+
+void UVEN_VisibilityService::QueryVisibility(const AActor* observer, const AActor* target, const FVector& observer_point, const FVEN_OnVisibilityChecked& callback)
+{
+	if (!target)
+	{
+		callback.ExecuteIfBound(false);
+		return;
+	}
+
+	const auto& line_of_sight_grid = GetLineOfSightGrid(observer);
+	if (line_of_sight_grid && line_of_sight_grid->IsLineOfSightBlocked(observer_point, target->GetActorLocation()))
+	{
+		callback.ExecuteIfBound(false);
+		return;
+	}
+
+	const FVisibilityKey key = MakeKey(observer, target, observer_point);
+	auto& entry = m_entries.FindOrAdd(key);
+
+	if (IsFresh(entry))
+	{
+		INC_DWORD_STAT(STAT_VEN_VisibilityCacheHits);
+		callback.ExecuteIfBound(entry.is_visible);
+		return;
+	}
+
+	entry.callbacks.Add(callback);
+	if (!entry.pending_trace_id)
+		StartAsyncTrace(key, entry, observer_point);
+}
+
+bool UVEN_VisibilityService::IsVisible(const AActor* observer, const AActor* target, const FVector& observer_point)
+{
+	if (!target || !GetWorld())
+		return false;
+
+	const auto& line_of_sight_grid = GetLineOfSightGrid(observer);
+	if (line_of_sight_grid && line_of_sight_grid->IsLineOfSightBlocked(observer_point, target->GetActorLocation()))
+		return false;
+
+	const FVisibilityKey key = MakeKey(observer, target, observer_point);
+	auto& entry = m_entries.FindOrAdd(key);
+
+	if (entry.has_result)
+	{
+		INC_DWORD_STAT(STAT_VEN_VisibilityCacheHits);
+
+		//outdated result is still used this frame, refreshed one comes with next frame
+		if (!IsFresh(entry) && !entry.pending_trace_id)
+			StartAsyncTrace(key, entry, observer_point);
+
+		return entry.is_visible;
+	}
+
+	INC_DWORD_STAT(STAT_VEN_VisibilitySyncTraces);
+
+	FHitResult trace_hit_result;
+	FCollisionQueryParams trace_params;
+	trace_params.AddIgnoredActor(observer);
+	const bool is_hit = GetWorld()->LineTraceSingleByChannel(trace_hit_result, observer_point, target->GetActorLocation(), ECC_Visibility, trace_params);
+
+	entry.is_visible = IsTraceClear(target, is_hit ? &trace_hit_result : nullptr);
+	entry.has_result = true;
+	entry.frame = GFrameCounter;
+
+	RemoveOutdatedEntries();
+	return m_entries.FindRef(key).is_visible;
+}
+
+const UVEN_LineOfSightGrid* UVEN_VisibilityService::GetLineOfSightGrid(const AActor* observer) const
+{
+	const auto& world = GetWorld();
+	const auto& game_mode = world ? Cast<AVEN_GameMode>(world->GetAuthGameMode()) : nullptr;
+	if (!game_mode || !game_mode->GetBattleSystem())
+	{
+		//debug_log("UVEN_VisibilityService::GetLineOfSightGrid. Battle system not found!", FColor::Red);
+		return nullptr;
+	}
+
+	//several battles run at once, each observer is answered by its own battle
+	const auto& battle = game_mode->GetBattleSystem()->GetBattle(observer);
+	return battle ? battle->GetLineOfSightGrid() : nullptr;
+}
+
+UVEN_VisibilityService::FVisibilityKey UVEN_VisibilityService::MakeKey(const AActor* observer, const AActor* target, const FVector& observer_point) const
+{
+	const auto bucket = [](const FVector& location)
+	{
+		return FIntVector(FMath::FloorToInt(location.X / POSITION_BUCKET_SIZE), FMath::FloorToInt(location.Y / POSITION_BUCKET_SIZE), FMath::FloorToInt(location.Z / POSITION_BUCKET_SIZE));
+	};
+
+	return { observer, target, bucket(observer_point), bucket(target->GetActorLocation()) };
+}
+
+bool UVEN_VisibilityService::IsFresh(const FVisibilityEntry& entry) const
+{
+	return entry.has_result && GFrameCounter - entry.frame <= MAX_RESULT_AGE_IN_FRAMES;
+}
+
+void UVEN_VisibilityService::StartAsyncTrace(const FVisibilityKey& key, FVisibilityEntry& entry, const FVector& observer_point)
+{
+	if (!GetWorld())
+		return;
+
+	INC_DWORD_STAT(STAT_VEN_VisibilityAsyncTraces);
+
+	FCollisionQueryParams trace_params;
+	trace_params.AddIgnoredActor(key.observer);
+
+	const uint32 trace_id = ++m_last_trace_id;
+	entry.pending_trace_id = trace_id;
+	m_pending_traces.Add(trace_id, key);
+
+	GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, observer_point, key.target->GetActorLocation(), ECC_Visibility, trace_params,
+		FCollisionResponseParams::DefaultResponseParam, &m_trace_delegate, trace_id);
+}
+
+void UVEN_VisibilityService::OnAsyncTraceCompleted(const FTraceHandle& trace_handle, FTraceDatum& trace_datum)
+{
+	FVisibilityKey key;
+	if (!m_pending_traces.RemoveAndCopyValue(trace_datum.UserData, key))
+		return;
+
+	auto entry = m_entries.Find(key);
+	if (!entry || entry->pending_trace_id != trace_datum.UserData)
+		return;
+
+	const FHitResult* blocking_hit = nullptr;
+	for (const auto& hit : trace_datum.OutHits)
+	{
+		if (hit.bBlockingHit)
+		{
+			blocking_hit = &hit;
+			break;
+		}
+	}
+
+	entry->is_visible = IsTraceClear(key.target, blocking_hit);
+	entry->has_result = true;
+	entry->frame = GFrameCounter;
+	entry->pending_trace_id = 0;
+
+	const bool is_visible = entry->is_visible;
+	const auto callbacks = MoveTemp(entry->callbacks);
+	entry->callbacks.Empty();
+
+	for (const auto& callback : callbacks)
+		callback.ExecuteIfBound(is_visible);
+
+	RemoveOutdatedEntries();
+}
+
+bool UVEN_VisibilityService::IsTraceClear(const AActor* target, const FHitResult* blocking_hit) const
+{
+	//nothing on the way or trace is stopped by target itself
+	return !blocking_hit || blocking_hit->GetActor() == target;
+}
+
+void UVEN_VisibilityService::RemoveOutdatedEntries()
+{
+	if (m_entries.Num() <= MAX_CACHED_ENTRIES)
+		return;
+
+	for (auto it = m_entries.CreateIterator(); it; ++it)
+	{
+		if (!it.Value().pending_trace_id && !IsFresh(it.Value()))
+			it.RemoveCurrent();
+	}
+}
\ No newline at end of file
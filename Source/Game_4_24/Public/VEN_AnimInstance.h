@@ -6,10 +6,73 @@
 
 #include "CoreMinimal.h"
 #include "Animation/AnimInstance.h"
+#include "Animation/AnimInstanceProxy.h"
 
 #include "VEN_AnimInstance.generated.h"
 
 class AActor;
+class UVEN_AnimInstance;
+
+//everything the animation graph reads, gathered on game thread and handed to the proxy once per frame.
+//triggers are one bit per graph flag: raised ones are set, lowered ones are cleared, the graph still
+//clears flags it consumed by itself. values are written into the graph only once c++ owns them,
+//until then the graph keeps its own (npc graphs set their animation index themselves)
+struct FVEN_AnimationSnapshot
+{
+	enum FIELD : uint8
+	{
+		SPEED = 1 << 0,
+		ANIMATION_INDEX = 1 << 1,
+		ACTION_INDEX = 1 << 2,
+		IN_BATTLE = 1 << 3
+	};
+
+	enum TRIGGER : uint16
+	{
+		PICK_ITEM = 1 << 0,
+		ATTACK_1 = 1 << 1,
+		ATTACK_2 = 1 << 2,
+		STUN_START = 1 << 3,
+		STUN_FINISH = 1 << 4,
+		RECEIVE_DAMAGE_FRONT = 1 << 5,
+		RECEIVE_DAMAGE_BACK = 1 << 6,
+		RECEIVE_DAMAGE_LEFT = 1 << 7,
+		RECEIVE_DAMAGE_RIGHT = 1 << 8,
+		DIE = 1 << 9
+	};
+
+	float speed = 0.f;
+	int32 animation_index = -1;
+	int32 action_index = 0;
+	bool in_battle = false;
+	uint16 raised_triggers = 0;
+	uint16 lowered_triggers = 0;
+	uint8 owned_fields = 0;
+};
+
+//takes the snapshot on game thread (PreUpdate) and writes it into graph variables on the animation
+//worker (Update), right before the graph reads them. owner calls may come at any moment of the frame
+//and never touch graph variables directly
+USTRUCT()
+struct GAME_4_24_API FVEN_AnimInstanceProxy : public FAnimInstanceProxy
+{
+	GENERATED_BODY()
+
+public:
+
+	FVEN_AnimInstanceProxy();
+	FVEN_AnimInstanceProxy(UAnimInstance* instance);
+
+protected:
+
+	void PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds) override;
+	void Update(float DeltaSeconds) override;
+
+private:
+
+	FVEN_AnimationSnapshot m_snapshot;
+
+};
 
 UCLASS()
 class GAME_4_24_API UVEN_AnimInstance : public UAnimInstance
@@ -30,6 +93,7 @@ public:
 	void OnUpdateFromOwner(vendetta::ANIMATION_UPDATE update);
 	void OnActionFromOwner(vendetta::ANIMATION_ACTION action);
 	vendetta::ANIMATION_ACTION GetActiveAnimationAction() const;
+	int GetAnimationIndex() const;
 	bool IsFree();
 
 public:
@@ -64,8 +128,17 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VEN_AnimInstance Battle Related")
 	bool Die;
 
+protected:
+
+	FAnimInstanceProxy* CreateAnimInstanceProxy() override;
+
 private:
 
+	friend struct FVEN_AnimInstanceProxy;
+
+	void RaiseTrigger(uint16 trigger);
+	void LowerTrigger(uint16 trigger);
+
 	void OwningUnitRegistration();
 	void UpdateForceStopStatus(vendetta::ANIMATION_NOTIFICATION notification);
 	void ResetActiveAction();
@@ -79,4 +152,7 @@ private:
 	vendetta::ANIMATION_ACTION m_active_action;
 	bool m_active_action_can_be_force_stopped;
 
+	//game thread side, taken by the proxy once per frame
+	FVEN_AnimationSnapshot m_pending_snapshot;
+
 };
@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "VEN_Types.h"
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "Tickable.h"
+
+#include "VEN_AnimationBudget.generated.h"
+
+class ACharacter;
+class AVEN_GameMode;
+class USkinnedMeshComponent;
+
+//caps how many npcs and enemy units evaluate animation at full rate. a few times per second characters
+//are ranked by significance and distance to camera focus: the best ones up to ven.AnimationBudget
+//animate every frame, the rest skip frames through update rate optimization with interpolation.
+//distant idle characters with the same mesh, animation blueprint and idle loop copy the pose of one of
+//them (master pose) instead of evaluating their own
+UCLASS()
+class GAME_4_24_API UVEN_AnimationBudget : public UObject, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	UVEN_AnimationBudget();
+
+public:
+
+	void Initialize();
+	void Uninitialize();
+	void RegisterCharacter(ACharacter* character);
+
+	void Tick(float DeltaTime) override;
+	bool IsTickable() const override;
+	TStatId GetStatId() const override;
+
+private:
+
+	struct FCandidate
+	{
+		int32 index;
+		vendetta::SIGNIFICANCE significance;
+		float distance_squared;
+	};
+
+	//skeletal mesh, animation blueprint class, idle loop index
+	using FIdlePoseKey = TTuple<const UObject*, const UClass*, int32>;
+
+	struct FCharacterState
+	{
+		int32 frame_skip = 0;
+		TWeakObjectPtr<USkinnedMeshComponent> leader;
+	};
+
+	AVEN_GameMode* GetGameMode() const;
+	void UpdateBudget();
+	//false if the character is busy and must animate on its own
+	bool GetIdlePoseKey(const ACharacter* character, FIdlePoseKey& key) const;
+	void ApplyState(ACharacter* character, FCharacterState& state, int32 frame_skip, USkinnedMeshComponent* leader);
+
+private:
+
+	UPROPERTY()
+	TArray<ACharacter*> m_characters;
+	//parallel to m_characters
+	TArray<FCharacterState> m_states;
+
+	float m_time_to_update;
+	bool m_is_initialized;
+
+};
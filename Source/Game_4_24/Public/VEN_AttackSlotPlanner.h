@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "VEN_NavigationService.h"
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+
+#include "VEN_AttackSlotPlanner.generated.h"
+
+class AActor;
+class AVEN_GameMode;
+class AVEN_EnemyUnit;
+class UVEN_BattleInstance;
+
+struct FVEN_AttackSlot
+{
+	AActor* target = nullptr;
+	FVector point = FVector::ZeroVector;
+};
+
+DECLARE_DELEGATE_OneParam(FVEN_OnAttackSlotAssigned, const FVEN_AttackSlot&);
+
+//assigns attack slots around player units to all enemy units at once (minimal total path length).
+//plan is built once per round and rebuilt only if player units moved or died
+UCLASS()
+class GAME_4_24_API UVEN_AttackSlotPlanner : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	UVEN_AttackSlotPlanner();
+
+public:
+
+	void Initialize();
+	void Invalidate();
+	void RequestAssignment(AVEN_EnemyUnit* enemy_unit, const FVEN_OnAttackSlotAssigned& callback);
+	void CancelRequest(AVEN_EnemyUnit* enemy_unit);
+
+private:
+
+	AVEN_GameMode* GetGameMode() const;
+	UVEN_BattleInstance* GetBattle() const;
+	bool IsPlanValid() const;
+	void StartPlanning();
+	void CancelPlanning();
+	bool IsSlotPointFree(const FVector& point, const AActor* slot_owner) const;
+	void OnEnemyUnitPathsEvaluated(const TArray<FVEN_PathQueryResult>& results, int32 enemy_unit_index, TArray<int32> slots_indices);
+	void FinishPlanning();
+	void ResolveRequests();
+
+private:
+
+	UPROPERTY()
+	TArray<AVEN_EnemyUnit*> m_enemy_units;
+	UPROPERTY()
+	TArray<AActor*> m_player_units;
+	TArray<FTransform> m_player_units_transforms;
+
+	//enemy units x slots, row by row
+	TArray<FVector> m_slots_points;
+	TArray<float> m_slots_costs;
+	TArray<FVEN_AttackSlot> m_assigned_slots;
+
+	TArray<uint32> m_paths_batches;
+	int32 m_pending_paths_batches_count;
+	bool m_planning_in_progress;
+	bool m_plan_is_ready;
+
+	TMap<AVEN_EnemyUnit*, FVEN_OnAttackSlotAssigned> m_requests;
+
+};
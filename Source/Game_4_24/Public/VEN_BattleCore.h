@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "VEN_Types.h"
+#include "VEN_TurnQueue.h"
+
+#include "CoreMinimal.h"
+#include "Math/RandomStream.h"
+
+//plain battle unit state, no actor behind it
+struct FVEN_BattleUnitRecord
+{
+	vendetta::BATTLE_FACTION faction = vendetta::BATTLE_FACTION::ENEMY;
+	int hp_current = 0;
+	int hp_total = 0;
+	//hp left when unit is defeated (player units are stunned with 1 hp)
+	int hp_on_defeat = 0;
+	float turn_points_left = 0.f;
+	float turn_points_total = 0.f;
+	int attack_power_min = 0;
+	int attack_power_max = 0;
+	int attack_range = 0;
+	float attack_price = 0.f;
+	bool is_dead = false;
+};
+
+struct FVEN_BattleAttackResult
+{
+	int damage = 0;
+	bool defender_died = false;
+	bool battle_can_be_finished = false;
+};
+
+struct FVEN_BattleSimulationResult
+{
+	bool is_finished = false;
+	vendetta::BATTLE_FACTION winner = vendetta::BATTLE_FACTION::ENEMY;
+	int turns = 0;
+};
+
+//battle rules without actors: turn queue, round starter, damage and finish conditions.
+//units are addressed by handles returned from AddUnit
+class GAME_4_24_API FVEN_BattleCore
+{
+public:
+
+	FVEN_BattleCore();
+
+	void Reset();
+	int32 AddUnit(const FVEN_BattleUnitRecord& record);
+	void Start();
+	void Finish();
+	bool IsInProgress() const;
+	bool IsGameOver() const;
+
+	const FVEN_BattleUnitRecord& GetUnit(int32 handle) const;
+	int32 GetUnitsCount() const;
+	const FVEN_TurnQueue& GetQueue() const;
+	const TArray<int32>& GetDiedUnits() const;
+	int32 GetCurrentTurnOwner() const;
+	bool IsRoundStarterTurn() const;
+
+	int RollAttackPower(int32 handle, FRandomStream& random_stream) const;
+	FVEN_BattleAttackResult Attack(int32 attacker, int32 defender, int damage);
+	void UpdateTurnPoints(int32 handle, float update_on_value);
+	void ResetAllTurnPoints();
+	void RemoveDiedUnits();
+	bool CanBattleBeFinished();
+	void ShiftQueue();
+	bool FinishCurrentTurn();
+
+	//plays the whole battle out with a simple policy: every unit attacks the weakest opponent while it has turn points
+	FVEN_BattleSimulationResult Simulate(FRandomStream& random_stream, int max_turns);
+
+private:
+
+	void ApplyDamage(int32 handle, int damage);
+	void ShiftRoundStarter();
+	int32 FindWeakestOpponent(int32 handle) const;
+	void PlayAutomaticTurn(FRandomStream& random_stream);
+
+private:
+
+	TArray<FVEN_BattleUnitRecord> m_units;
+	FVEN_TurnQueue m_queue;
+	//died since last RemoveDiedUnits, they stay in queue until the turn is finished
+	TArray<int32> m_units_to_remove;
+	TArray<int32> m_died_units;
+	int32 m_round_starter;
+	bool m_in_progress;
+	bool m_game_over;
+
+};
@@ -0,0 +1,138 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "VEN_BattleCore.h"
+#include "VEN_BattleReplay.h"
+#include "VEN_NavigationFilter.h"
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "TimerManager.h"
+
+#include "VEN_BattleInstance.generated.h"
+
+class AActor;
+class AVEN_GameMode;
+class AVEN_MainController;
+class UVEN_BattleSystem;
+class UVEN_AttackSlotPlanner;
+class UVEN_LineOfSightGrid;
+class IVEN_BattleParticipant;
+
+//one running battle: its units, turn queue, attack slots and turn timer.
+//instances are owned and reused by the battle system, only battles with player units drive the ui
+UCLASS()
+class GAME_4_24_API UVEN_BattleInstance : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	enum BATTLE_NOTIFY_TYPE
+	{
+		START_BATTLE,
+		FINISH_BATTLE,
+		START_NEW_TURN,
+		FINISH_CURRENT_TURN,
+		GAME_OVER
+	};
+
+	UVEN_BattleInstance();
+
+public:
+
+	void Initialize(UVEN_BattleSystem* battle_system);
+	void Uninitialize();
+	bool IsBattleInProgress() const;
+	bool IsGameOver() const;
+	bool IsPlayerBattle() const;
+	void StartBattle(AActor* attacker, AActor* defender);
+	void FinishBattle();
+	void Attack(AActor* attacker, AActor* defender);
+	void PrepareNextTurn();
+	void StartNextTurn();
+	void FinishCurrentTurn(AActor* requestor);
+	void RecordMovement(AActor* unit, const FVector& start, const FVector& end);
+	const TArray<AActor*>& GetBattleUnits() const;
+	TArray<AActor*> GetAllUnitsInBattle() const;
+	const TArray<AActor*>& GetPlayerUnitsInBattle() const;
+	const TArray<AActor*>& GetEnemyUnitsInBattle() const;
+	UVEN_AttackSlotPlanner* GetAttackSlotPlanner() const;
+	UVEN_LineOfSightGrid* GetLineOfSightGrid() const;
+	const TArray<FVEN_NavigationBlocker>& GetNavigationBlockers() const;
+	uint32 GetBattleStateRevision() const;
+	//every roll of the battle goes through this stream, same seed and same decisions give the same battle
+	int32 GetRandomSeed() const;
+	FRandomStream& GetRandomStream();
+	bool IsCurrentTurnOwner(const AActor* actor) const;
+	void UpdateBlueprintBattleQueue();
+	//pushes queue, turn owner and line of sight grid when this battle takes over the widgets
+	void UpdateBlueprintWidgets();
+
+private:
+
+	void Notify(BATTLE_NOTIFY_TYPE notification);
+	void SetupBattleUnitsQueue(AActor* attacker, AActor* defender);
+	void AddUnitToBattle(AActor* unit);
+	void ClearBattleUnits();
+	void UpdateBattleUnitsQueue();
+	void ShiftBattleUnitsQueue();
+	void UpdateBlueprintTurnOwner();
+	AActor* GetCurrentTurnOwner() const;
+	AActor* GetUnitByHandle(int32 handle) const;
+	IVEN_BattleParticipant* GetParticipantByHandle(int32 handle) const;
+
+	AVEN_GameMode* GetGameMode() const;
+	AVEN_MainController* GetMainController() const;
+	void UpdateNavigationBlockers();
+	void BuildLineOfSightGrid(AActor* attacker, AActor* defender);
+	void UpdateNavMeshTilesStat(bool reset_snapshot);
+	bool CanBattleBeFinished();
+	void ResetAllTurnPoints();
+	void TeleportStragglerPlayerUnit();
+	void StartReplayRecording();
+	void FlushReplayRecording(bool is_finished);
+
+private:
+
+	UPROPERTY()
+	UVEN_BattleSystem* m_battle_system;
+
+	//turn order, damage and finish rules live in the core, actors are indexed by core handles
+	FVEN_BattleCore m_battle_core;
+	UPROPERTY()
+	TArray<AActor*> m_battle_units;
+	//the same units through their battle interface, kept alive by m_battle_units
+	TArray<IVEN_BattleParticipant*> m_participants;
+	//alive units of every faction, updated when units join or leave the queue
+	UPROPERTY()
+	TArray<AActor*> m_player_units;
+	UPROPERTY()
+	TArray<AActor*> m_enemy_units;
+	UPROPERTY()
+	UVEN_AttackSlotPlanner* m_attack_slot_planner;
+	UPROPERTY()
+	UVEN_LineOfSightGrid* m_line_of_sight_grid;
+	//player units joined at start, such battle owns popups, music and battle widgets
+	bool m_is_player_battle;
+	//turn owner got its turn and has not finished it yet
+	bool m_is_turn_in_progress;
+
+	//units never dirty navmesh, path queries avoid them through the navigation filter
+	TArray<FVEN_NavigationBlocker> m_navigation_blockers;
+	//tiles salts snapshot, changed salt means the tile was rebuilt
+	TArray<uint32> m_nav_mesh_tiles_salt;
+	//bumped when units take damage, die or the turn changes, views cache their results by it
+	uint32 m_battle_state_revision;
+
+	int32 m_random_seed;
+	FRandomStream m_random_stream;
+
+	FVEN_BattleReplay m_replay;
+	FString m_replay_file_path;
+
+	UPROPERTY()
+	FTimerHandle m_tmr_before_next_turn;
+
+};
@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "VEN_Types.h"
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+
+#include "VEN_BattleParticipant.generated.h"
+
+struct FVEN_BattleUnitRecord;
+
+UINTERFACE(MinimalAPI)
+class UVEN_BattleParticipant : public UInterface
+{
+	GENERATED_BODY()
+};
+
+//common battle side of player and enemy units. battle system casts a unit once when it joins
+//the battle and then dispatches through this interface
+class GAME_4_24_API IVEN_BattleParticipant
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual vendetta::BATTLE_FACTION GetBattleFaction() const = 0;
+	virtual FVEN_BattleUnitRecord GetBattleUnitRecord() const = 0;
+	//puts hp and defeat state of a replay record on the unit, false if the unit cannot get back to it
+	virtual bool ApplyBattleUnitRecord(const FVEN_BattleUnitRecord& record) = 0;
+	virtual FBattleQueueUnitInfo GetBattleQueueUnitInfo() const = 0;
+	virtual void OnStartBattle() = 0;
+	virtual void OnFinishBattle() = 0;
+	virtual void OnStartBattleTurn() = 0;
+	virtual void OnFinishBattleTurn() = 0;
+	virtual void ResetTurnPoints() = 0;
+
+};
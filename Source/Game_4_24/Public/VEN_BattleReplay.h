@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "VEN_Types.h"
+#include "VEN_BattleCore.h"
+
+#include "CoreMinimal.h"
+
+struct FVEN_BattleReplayUnit
+{
+	//actor name in the level, replay finds the same units by it
+	FString name;
+	FVEN_BattleUnitRecord record;
+	FVector location = FVector::ZeroVector;
+};
+
+struct FVEN_BattleReplayEvent
+{
+	vendetta::BATTLE_REPLAY_EVENT type = vendetta::BATTLE_REPLAY_EVENT::START;
+	//units are addressed by battle core handles
+	int32 unit = INDEX_NONE;
+	int32 target = INDEX_NONE;
+	int damage = 0;
+	FVector start = FVector::ZeroVector;
+	FVector end = FVector::ZeroVector;
+	bool game_over = false;
+};
+
+//compact binary log of one battle. events are appended while the battle goes and flushed to the end of
+//the file at turn boundaries, so a crash loses at most the current turn. integers are zigzag packed and
+//locations are rounded to whole units, a common battle takes a few KB
+class GAME_4_24_API FVEN_BattleReplay
+{
+public:
+
+	FVEN_BattleReplay();
+
+	void Reset();
+	bool IsRecording() const;
+
+	void RecordStart(int32 seed, const TArray<FVEN_BattleReplayUnit>& units);
+	void RecordMove(int32 unit, const FVector& start, const FVector& end);
+	void RecordAttack(int32 attacker, int32 defender, int damage);
+	void RecordTurnEnd(int32 unit);
+	void RecordDeath(int32 unit);
+	void RecordFinish(bool game_over);
+	//appends everything recorded since previous flush
+	bool Flush(const FString& file_path);
+
+	bool Load(const FString& file_path);
+	bool Parse(const TArray<uint8>& data);
+	int32 GetSeed() const;
+	int32 GetDataSize() const;
+	const TArray<FVEN_BattleReplayUnit>& GetUnits() const;
+	const TArray<FVEN_BattleReplayEvent>& GetEvents() const;
+
+private:
+
+	static void WriteInt(FArchive& archive, int32 value);
+	static int32 ReadInt(FArchive& archive);
+	static void WriteLocation(FArchive& archive, const FVector& location);
+	static FVector ReadLocation(FArchive& archive);
+	void WriteEvent(vendetta::BATTLE_REPLAY_EVENT type, TFunctionRef<void(FArchive&)> write_payload);
+
+private:
+
+	TArray<uint8> m_data;
+	int32 m_flushed_size;
+
+	int32 m_seed;
+	TArray<FVEN_BattleReplayUnit> m_units;
+	TArray<FVEN_BattleReplayEvent> m_events;
+
+};
@@ -0,0 +1,56 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "VEN_BattleReplay.h"
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "TimerManager.h"
+
+#include "VEN_BattleReplayPlayer.generated.h"
+
+class AActor;
+class AVEN_GameMode;
+
+//drives level units from a battle replay: units are put to their start locations, moves jump to path
+//end points and attacks deal recorded damage. with skip animations the whole log is applied at once,
+//otherwise events are spread in time so hit and death animations play out.
+//ven.ReplayBattle <file in Saved/BattleReplays or full path> [skipanimations]
+UCLASS()
+class GAME_4_24_API UVEN_BattleReplayPlayer : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	UVEN_BattleReplayPlayer();
+
+public:
+
+	bool Start(const FString& file_path, bool skip_animations);
+	void Stop();
+	bool IsInProgress() const;
+
+private:
+
+	void PlayNextEvents();
+	//true if the event takes time to be seen
+	bool ApplyEvent(const FVEN_BattleReplayEvent& event);
+	AActor* FindUnit(const FString& name) const;
+	void TeleportUnit(AActor* unit, const FVector& location, const FVector& look_at_location);
+	AVEN_GameMode* GetGameMode() const;
+
+private:
+
+	FVEN_BattleReplay m_replay;
+	UPROPERTY()
+	TArray<AActor*> m_units;
+	int32 m_next_event_index;
+	bool m_skip_animations;
+	bool m_in_progress;
+
+	UPROPERTY()
+	FTimerHandle m_tmr_next_events;
+
+};
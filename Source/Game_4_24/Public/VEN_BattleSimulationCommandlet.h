@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "VEN_BattleCore.h"
+#include "VEN_BattleReplay.h"
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "VEN_BattleSimulationCommandlet.generated.h"
+
+//runs batches of headless battles for balancing:
+//UE4Editor-Cmd Game_4_24.uproject -run=VEN_BattleSimulation -nullrhi -battles=100000 -seed=1
+//	-players=hp:turn_points:attack_min:attack_max:attack_range:attack_price,... -enemies=... -maxturns=200
+//turn queue micro-benchmark (ring queue against plain array) instead of battles:
+//UE4Editor-Cmd Game_4_24.uproject -run=VEN_BattleSimulation -nullrhi -queuebenchmark=128 -iterations=100000
+//recorded battle replayed against battle rules, checks the log still matches them and times it:
+//UE4Editor-Cmd Game_4_24.uproject -run=VEN_BattleSimulation -nullrhi -replay=<file in Saved/BattleReplays or full path> -iterations=1000
+UCLASS()
+class GAME_4_24_API UVEN_BattleSimulationCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UVEN_BattleSimulationCommandlet();
+
+	int32 Main(const FString& Params) override;
+
+private:
+
+	bool ParseUnits(const FString& units_description, vendetta::BATTLE_FACTION faction, TArray<FVEN_BattleUnitRecord>& units) const;
+	void RunTurnQueueBenchmark(int32 participants_count, int32 iterations, int32 seed) const;
+	bool RunReplay(const FString& file_path, int32 iterations) const;
+	//false on the first event battle rules disagree with
+	bool ReplayBattle(const FVEN_BattleReplay& replay) const;
+
+};
@@ -2,92 +2,97 @@
 
 #pragma once
 
+#include "VEN_BattleInstance.h"
+#include "VEN_BattleReplayPlayer.h"
+
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
-#include "TimerManager.h"
 
 #include "VEN_BattleSystem.generated.h"
 
 class AActor;
-class AVEN_GameMode;
-class AVEN_MainController;
 
+struct FVEN_BattlePopupRequest
+{
+	UVEN_BattleInstance* battle;
+	EWidgetBattleRequestType request;
+};
+
+//owns every running battle. battles are independent instances with their own queue, attack slots
+//and turn timer, finished instances are kept for reuse. unit calls are routed to the battle of the unit
 UCLASS()
 class GAME_4_24_API UVEN_BattleSystem : public UObject
 {
 	GENERATED_BODY()
-		
-public:
 
-	enum BATTLE_NOTIFY_TYPE
-	{
-		START_BATTLE,
-		FINISH_BATTLE,
-		START_NEW_TURN,
-		FINISH_CURRENT_TURN,
-		GAME_OVER
-	};
+public:
 
 	UVEN_BattleSystem();
-	
+
 public:
 
 	void Initialize();
 	void Uninitialize();
 	void InitializeBattleTeleportPoints(FTransform point1, FTransform point2);
+	FTransform GetFarthestTeleportPoint(const FVector& location) const;
+	//scripted gate for battles with player units, running battles never touch it
 	bool GetBattleAllowed() const;
 	void SetBattleAllowed(bool is_allowed);
+	//any player battle is running, ui and controls care only about them
 	bool IsBattleInProgress() const;
 	bool IsGameOver() const;
+	//units are gated one by one, battle elsewhere does not block them
+	bool CanStartBattle(AActor* attacker, AActor* defender) const;
 	void StartBattle(AActor* attacker, AActor* defender);
-	void FinishBattle();
 	void Attack(AActor* attacker, AActor* defender);
-	void PrepareNextTurn();
-	void StartNextTurn();
 	void FinishCurrentTurn(AActor* requestor);
-	TArray<AActor*> GetAllUnitsInBattle() const;
-	TArray<AActor*> GetPlayerUnitsInBattle() const;
-	TArray<AActor*> GetEnemyUnitsInBattle() const;
-	TArray<FVector> GetEnemyUnitReservedAttackPoints() const;
-	void AddEnemyUnitReservedAttackPoint(FVector point);
-	bool IsCurrentTurnOwner(AActor* actor) const;
-	void UpdateBlueprintBattleQueue();
+	bool IsCurrentTurnOwner(const AActor* actor) const;
+	void UpdateBlueprintBattleQueue(const AActor* unit);
+	void RecordMovement(AActor* unit, const FVector& start, const FVector& end);
 	void OnStartPopupShown();
 	void OnFinalPopupShown();
 
-private:
+	UVEN_BattleInstance* GetBattle(const AActor* unit) const;
+	//oldest running player battle, it owns battle queue and turn owner widgets
+	UVEN_BattleInstance* GetPlayerBattle() const;
+	const TArray<UVEN_BattleInstance*>& GetPlayerBattles() const;
+	bool IsInBattle(const AActor* unit) const;
+	int32 GetBattlesInProgressCount() const;
+
+	//replays drive level units, battles cannot start meanwhile
+	bool StartReplay(const FString& file_path, bool skip_animations);
+	bool IsReplayInProgress() const;
+
+	//called by instances
+	void OnBattleStarted(UVEN_BattleInstance* battle);
+	void OnBattleFinished(UVEN_BattleInstance* battle);
+	void RequestBattlePopup(UVEN_BattleInstance* battle, EWidgetBattleRequestType request);
 
-	void Notify(BATTLE_NOTIFY_TYPE notification);
-	void SetupBattleUnitsQueue(AActor* attacker, AActor* defender);
-	void UpdateBattleUnitsQueue();
-	void ShiftBattleUnitsQueue();
-	AActor* GetCurrentTurnOwner() const;
+private:
 
-	AVEN_GameMode* GetGameMode() const;
-	AVEN_MainController* GetMainController() const;
-	void AdjustUnitsCollisions();
-	bool CanBattleBeFinished();
-	void ShiftRoundStarter();
-	void ResetAllTurnPoints();
-	void TeleportStragglerPlayerUnit();
+	UVEN_BattleInstance* AcquireBattle();
+	void ShowNextBattlePopup();
+	bool IsAwaitingFinalPopup(const AActor* unit) const;
 
 private:
 
-	bool m_battle_is_in_progress;
 	bool m_battle_is_allowed;
-	bool m_game_over;
+	//any player battle lost, no battle starts anymore
+	bool m_is_game_over;
 
+	//every instance ever created, free ones are reused before creating new
 	UPROPERTY()
-	AActor* m_battle_round_starter;
-
+	TArray<UVEN_BattleInstance*> m_battles;
 	UPROPERTY()
-	TArray<AActor*> m_battle_units_queue;
+	TArray<UVEN_BattleInstance*> m_free_battles;
 	UPROPERTY()
-	TArray<AActor*> m_battle_died_units;
-	TArray<FVector> m_enemy_unit_reserved_attack_points;
-
+	TArray<UVEN_BattleInstance*> m_player_battles;
+	TMap<const AActor*, UVEN_BattleInstance*> m_units_battles;
+	//one popup is shown at a time, battles are kept alive by m_battles.
+	//finished player battle returns to free ones once its final popup is shown
+	TArray<FVEN_BattlePopupRequest> m_popup_requests;
 	UPROPERTY()
-	FTimerHandle m_tmr_before_next_turn;
+	UVEN_BattleReplayPlayer* m_replay_player;
 
 	FTransform m_teleport_point_1;
 	FTransform m_teleport_point_2;
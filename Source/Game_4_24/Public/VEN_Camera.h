@@ -106,6 +106,8 @@ private:
 	bool m_camera_jump_over_mode;
 	bool m_camera_jump_over_finished;
 	FVector m_camera_jump_over_impact_point;
+	//ground below the camera is traced again only after the camera moves
+	FVector m_camera_last_traced_location;
 
 	UPROPERTY()
 	UMaterialInterface* m_transparent_material;
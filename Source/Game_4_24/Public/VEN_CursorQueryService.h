@@ -0,0 +1,45 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "Engine/EngineTypes.h"
+
+#include "VEN_Types.h"
+
+#include "VEN_CursorQueryService.generated.h"
+
+class APlayerController;
+
+//traces under cursor at most once per frame, all cursor consumers share the same hit result
+UCLASS()
+class GAME_4_24_API UVEN_CursorQueryService : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	UVEN_CursorQueryService();
+
+public:
+
+	void Initialize();
+	//does nothing if cursor was already traced this frame
+	void Update(APlayerController* controller);
+
+	const FHitResult& GetHitResult() const;
+	AActor* GetHoveredActor() const;
+	vendetta::CURSOR_TARGET GetHoveredActorType() const;
+
+private:
+
+	vendetta::CURSOR_TARGET ClassifyActor(const AActor* actor) const;
+
+private:
+
+	FHitResult m_hit_result;
+	vendetta::CURSOR_TARGET m_hovered_actor_type;
+	uint64 m_last_update_frame;
+
+};
@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "Styling/SlateBrush.h"
+#include "Tickable.h"
+
+#include "VEN_EnemyIndicators.generated.h"
+
+class AVEN_GameMode;
+class AVEN_EnemyUnit;
+class UMaterialInterface;
+class UMaterialInstanceDynamic;
+class SVEN_EnemyIndicatorsOverlay;
+
+//owns rank indicators of all enemy units. sensing percent is quantised and an indicator is stored only when
+//its step changes; the overlay list is rebuilt at most once per frame and only after such a change. every
+//rank and step has its own brush over the rank material, so one overlay widget paints all indicators in a
+//few batches instead of a widget component per enemy
+UCLASS()
+class GAME_4_24_API UVEN_EnemyIndicators : public UObject, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	UVEN_EnemyIndicators();
+
+public:
+
+	void Initialize();
+	void Uninitialize();
+	//false until the overlay is in the viewport, enemies keep their own rank widget then
+	bool IsOverlayActive() const;
+	//percent is 0..1, true if the quantised indicator has changed
+	bool UpdateIndicator(AVEN_EnemyUnit* enemy_unit, bool show, float percent = 0.f);
+
+	void Tick(float DeltaTime) override;
+	bool IsTickable() const override;
+	TStatId GetStatId() const override;
+
+private:
+
+	AVEN_GameMode* GetGameMode() const;
+	void AddOverlay();
+	void RemoveOverlay();
+	void UpdateOverlay();
+	const FSlateBrush* GetBrush(const AVEN_EnemyUnit* enemy_unit, int32 step);
+
+private:
+
+	UPROPERTY()
+	TArray<AVEN_EnemyUnit*> m_enemy_units;
+	//parallel to m_enemy_units, quantised sensing percent or INDEX_NONE when hidden
+	TArray<int32> m_steps;
+
+	UPROPERTY()
+	UMaterialInterface* m_common_rank_material;
+	UPROPERTY()
+	UMaterialInterface* m_leader_rank_material;
+	//rank by step, created on first use. brushes are sized once, overlay keeps pointers to them
+	UPROPERTY()
+	TArray<UMaterialInstanceDynamic*> m_step_materials;
+	TArray<FSlateBrush> m_step_brushes;
+
+	TSharedPtr<SVEN_EnemyIndicatorsOverlay> m_overlay;
+	bool m_is_dirty;
+	bool m_is_initialized;
+
+};
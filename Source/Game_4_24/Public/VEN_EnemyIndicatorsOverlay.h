@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SLeafWidget.h"
+
+class AActor;
+class APlayerController;
+struct FSlateBrush;
+
+struct FVEN_EnemyIndicator
+{
+	TWeakObjectPtr<const AActor> actor;
+	//above actor location
+	float height = 0.f;
+	//rank art with sensing percent baked into its material
+	const FSlateBrush* brush = nullptr;
+};
+
+//every enemy rank indicator painted by a single leaf widget over the viewport. indicators follow their
+//actors on paint, so the list is only replaced when some indicator changes
+class GAME_4_24_API SVEN_EnemyIndicatorsOverlay : public SLeafWidget
+{
+public:
+
+	SLATE_BEGIN_ARGS(SVEN_EnemyIndicatorsOverlay)
+		: _IndicatorSize(FVector2D(48.f, 48.f))
+	{
+		_Visibility = EVisibility::HitTestInvisible;
+	}
+		SLATE_ARGUMENT(TWeakObjectPtr<APlayerController>, PlayerController)
+		SLATE_ARGUMENT(FVector2D, IndicatorSize)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+	void SetIndicators(TArray<FVEN_EnemyIndicator>&& indicators);
+
+	int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
+	FVector2D ComputeDesiredSize(float LayoutScaleMultiplier) const override;
+
+private:
+
+	TWeakObjectPtr<APlayerController> m_player_controller;
+	FVector2D m_indicator_size;
+	TArray<FVEN_EnemyIndicator> m_indicators;
+
+};
@@ -3,6 +3,9 @@
 #pragma once
 
 #include "VEN_Types.h"
+#include "VEN_BattleParticipant.h"
+#include "VEN_AttackSlotPlanner.h"
+#include "VEN_MovementTrack.h"
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
@@ -16,11 +19,12 @@ class UVEN_BattleSystem;
 class UVEN_QuestsManager;
 class UVEN_AnimInstance;
 class USplineComponent;
-class UPawnSensingComponent;
+class AVEN_PlayerUnit;
 class UDecalComponent;
+struct FVEN_BattleUnitRecord;
 
 UCLASS()
-class GAME_4_24_API AVEN_EnemyUnit : public ACharacter
+class GAME_4_24_API AVEN_EnemyUnit : public ACharacter, public IVEN_BattleParticipant
 {
 	GENERATED_BODY()
 
@@ -31,6 +35,7 @@ public:
 protected:
 
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	void Tick(float DeltaTime) override;
 
 public:
@@ -43,10 +48,10 @@ public:
 
 	/* BATTLE */
 
-	void OnStartBattle();
-	void OnFinishBattle();
-	void OnStartBattleTurn();
-	void OnFinishBattleTurn();
+	void OnStartBattle() override;
+	void OnFinishBattle() override;
+	void OnStartBattleTurn() override;
+	void OnFinishBattleTurn() override;
 	void OnTargetDied();
 	void OnReceiveDamage(float damage_received, AActor* damage_dealer);
 	EEnemyUnitType GetUnitType() const;
@@ -54,22 +59,31 @@ public:
 	int GetTotalHP() const;
 	int GetAttackPowerMin() const;
 	int GetAttackPowerMax() const;
-	int GetRandomAttackPower() const;
+	int GetRandomAttackPower(FRandomStream& random_stream) const;
 	int GetAttackRange() const;
 	float GetAttackPrice() const;
 	float GetTurnPointsTotal() const;
 	float GetTurnPointsLeft() const;
 	void UpdateTurnPoints(float update_on_value);
-	void ResetTurnPoints();
+	void ResetTurnPoints() override;
 	bool IsDead() const;
+	vendetta::BATTLE_FACTION GetBattleFaction() const override;
+	FVEN_BattleUnitRecord GetBattleUnitRecord() const override;
+	bool ApplyBattleUnitRecord(const FVEN_BattleUnitRecord& record) override;
+	FBattleQueueUnitInfo GetBattleQueueUnitInfo() const override;
 	TArray<vendetta::QUEST_ID> GetRelatedQuestIds() const;
 	void EnableSensing(bool enable = true);
+	bool IsSensingEnabled() const;
+	bool IsSensingActive() const;
+	AActor* GetSensingTarget() const;
+	float GetSensingRadius() const;
+	bool IsInSensingCone(const AActor* target) const;
+	FVector GetSensingViewPoint() const;
+	void OnPlayerUnitSensed(AVEN_PlayerUnit* player_unit);
+	void OnSensingTargetVisibilityUpdate(bool is_visible);
 
 protected:
 
-	UFUNCTION()
-	void OnSeePawn(APawn* other_pawn);
-
 	UFUNCTION(BlueprintImplementableEvent, meta = (DisplayName = "On Map Icon Update"))
 	void OnMapIconUpdate(bool is_alive);
 	UFUNCTION(BlueprintImplementableEvent, meta = (DisplayName = "On Rank Widget Update"))
@@ -95,17 +109,14 @@ private:
 	void AttackAnimationStart();
 	void Die();
 	bool IsEnoughPointsForAction(vendetta::IN_BATTLE_UNIT_ACTION action);
-	void CalculateAttackPoints(TMap<AActor*, TArray<FVector>>& attack_points_by_player_unit);
-	void GatherAllCalculatedPoints(TMap<AActor*, TArray<FVector>>& attack_points_by_player_unit, TArray<FVector>& all_points);
-	void ValidateAttackPoints(TArray<FVector>& points);
-	void SortAttackPoints(TArray<FVector>& points);
-	FVector GetClosestAttackPoint(TArray<FVector>& points) const;
-	AActor* GetAttackPointTarget(FVector point, TMap<AActor*, TArray<FVector>>& attack_points_by_player_unit) const;
 	void MakeDecision();
-	void ReservePoint(FVector point);
 	void SensingPlayerUnit(float DeltaTime);
+	void UpdateTickEnabled();
+	void UpdateRankIndicator(bool show, float percent = 0.f);
 	void RotateToPlayerUnit();
 	void FindTarget();
+	void CancelTargetSearch();
+	void OnAttackSlotAssigned(const FVEN_AttackSlot& slot);
 	vendetta::DIRECTION GetAttackDirection(FRotator attacker_rotation) const;
 
 public:
@@ -136,8 +147,6 @@ protected:
 	int m_attack_range;
 	UPROPERTY(EditAnywhere, Category = "In Battle Properties")
 	float m_attack_price;
-	UPROPERTY(EditAnywhere, Category = "In Battle Properties")
-	UPawnSensingComponent* m_sensing_component;
 
 private:
 
@@ -147,6 +156,8 @@ private:
 	AActor* m_movement_spline_actor;
 	UPROPERTY()
 	USplineComponent* m_movement_spline_component;
+	//baked from the spline in StartMovement
+	FVEN_MovementTrack m_movement_track;
 
 	bool m_movement_spline_is_built;
 	bool m_is_currently_moving;
@@ -166,9 +177,15 @@ private:
 	UPROPERTY()
 	AActor* m_current_target;
 
+	bool m_target_search_in_progress;
+	bool m_decision_is_pending;
+
 	bool m_sensing_is_enabled;
 	bool m_sensing_is_active;
+	bool m_sensing_target_is_visible;
 	float m_sensing_current_percent;
 	FRotator m_rotation_before_sensing;
 
+	bool m_rank_widget_is_hidden;
+
 };
@@ -9,6 +9,14 @@
 #include "VEN_QuestsManager.h"
 #include "VEN_BattleSystem.h"
 #include "VEN_CursorManager.h"
+#include "VEN_NavigationService.h"
+#include "VEN_PerceptionManager.h"
+#include "VEN_VisibilityService.h"
+#include "VEN_CursorQueryService.h"
+#include "VEN_UnitsSpatialHash.h"
+#include "VEN_SignificanceManager.h"
+#include "VEN_AnimationBudget.h"
+#include "VEN_EnemyIndicators.h"
 
 #include "CoreMinimal.h"
 #include "GameFramework/GameModeBase.h"
@@ -39,6 +47,14 @@ public:
 	UVEN_QuestsManager* GetQuestsManager() const;
 	UVEN_BattleSystem* GetBattleSystem() const;
 	UVEN_CursorManager* GetCursorManager() const;
+	UVEN_NavigationService* GetNavigationService() const;
+	UVEN_PerceptionManager* GetPerceptionManager() const;
+	UVEN_VisibilityService* GetVisibilityService() const;
+	UVEN_CursorQueryService* GetCursorQueryService() const;
+	UVEN_UnitsSpatialHash* GetUnitsSpatialHash() const;
+	UVEN_SignificanceManager* GetSignificanceManager() const;
+	UVEN_AnimationBudget* GetAnimationBudget() const;
+	UVEN_EnemyIndicators* GetEnemyIndicators() const;
 	TArray<int> GetInventory() const;
 
 	void RequestUniqueId(AActor* actor);
@@ -112,6 +128,14 @@ private:
 	void InitializeQuestsManager();
 	void InitializeBattleSystem();
 	void InitializeCursorManager();
+	void InitializeNavigationService();
+	void InitializePerceptionManager();
+	void InitializeVisibilityService();
+	void InitializeCursorQueryService();
+	void InitializeUnitsSpatialHash();
+	void InitializeSignificanceManager();
+	void InitializeAnimationBudget();
+	void InitializeEnemyIndicators();
 	void GatherPlayerUnits();
 	void UninitializePlayerUnits();
 
@@ -127,4 +151,20 @@ private:
 	UVEN_BattleSystem* m_battle_system;
 	UPROPERTY()
 	UVEN_CursorManager* m_cursor_manager;
+	UPROPERTY()
+	UVEN_NavigationService* m_navigation_service;
+	UPROPERTY()
+	UVEN_PerceptionManager* m_perception_manager;
+	UPROPERTY()
+	UVEN_VisibilityService* m_visibility_service;
+	UPROPERTY()
+	UVEN_CursorQueryService* m_cursor_query_service;
+	UPROPERTY()
+	UVEN_UnitsSpatialHash* m_units_spatial_hash;
+	UPROPERTY()
+	UVEN_SignificanceManager* m_significance_manager;
+	UPROPERTY()
+	UVEN_AnimationBudget* m_animation_budget;
+	UPROPERTY()
+	UVEN_EnemyIndicators* m_enemy_indicators;
 };
@@ -37,6 +37,7 @@ public:
 	bool IsCollectible() const;
 	float GetInteractableRadius() const;
 	bool CanBeInteractedRightNow();
+	void ActivateParticleSystem(bool activate = true);
 
 protected:
 
@@ -54,7 +55,6 @@ private:
 	void SetupUniqueId();
 	void InitializeRelatedQuestsIds();
 	AVEN_GameMode* GetGameMode() const;
-	void ActivateParticleSystem();
 
 private:
 
@@ -0,0 +1,21 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class USplineComponent;
+class AActor;
+class UVEN_LineOfSightGrid;
+
+namespace vendetta
+{
+	//first point along path polyline which is within interaction radius of target (ignoring z) and passes
+	//visibility check. parts of polyline inside the radius are found analytically, probed at most 200 uu apart
+	//and the first hidden to visible change is bisected down to 25 uu
+	bool find_interaction_location(const TArray<FVector>& path_points, const FVector& target_location, float interaction_radius, TFunctionRef<bool(const FVector&)> is_target_visible, FVector& interaction_location);
+
+	//find_interaction_location over path spline points, visibility is traced from height offset above the path
+	//(battle grid rejects blocked checkpoints without tracing). returns zero vector if there is no such point
+	FVector find_interaction_point(const USplineComponent* path_spline, const AActor* interacting_actor, const AActor* target_actor, float interaction_radius, float height_offset, const UVEN_LineOfSightGrid* line_of_sight_grid = nullptr);
+}
@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "Tickable.h"
+#include "CollisionQueryParams.h"
+
+#include "VEN_LineOfSightGrid.generated.h"
+
+class AActor;
+class UVEN_BattleInstance;
+
+//battle scoped line of sight. battle area is sampled into cells at battle start and cell to cell
+//visibility is traced on the visibility channel (battle units ignored) a few rows per frame.
+//grid answers only "blocked", clear sight is always confirmed by a real trace of the caller
+UCLASS()
+class GAME_4_24_API UVEN_LineOfSightGrid : public UObject, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	UVEN_LineOfSightGrid();
+
+public:
+
+	void Initialize(UVEN_BattleInstance* battle);
+	void Reset();
+	//eye height is counted from the ground, pairs further than max distance are not traced.
+	//only ground is found here, the matrix is filled by Tick
+	void Build(const FVector& center, float radius, float eye_height, float max_distance);
+	bool IsValid() const;
+	//true only if sight is blocked between every pair of cells around both points,
+	//false means unknown (outside of the grid, rows not traced yet or possibly clear)
+	bool IsLineOfSightBlocked(const FVector& start, const FVector& end) const;
+
+	void Tick(float DeltaTime) override;
+	bool IsTickable() const override;
+	TStatId GetStatId() const override;
+
+private:
+
+	int32 GetGridIndex(const FVector& location) const;
+	bool GatherNearbyCells(const FVector& location, TArray<int32, TInlineAllocator<4>>& cells) const;
+	bool IsCellsPairBlocked(int32 from_cell, int32 to_cell) const;
+
+private:
+
+	UPROPERTY()
+	UVEN_BattleInstance* m_battle;
+
+	FVector m_origin;
+	int32 m_cells_per_side;
+	//eye point per cell, invalid cells (no ground) have no entry in m_cells_indices
+	TArray<FVector> m_eye_points;
+	TArray<int32> m_cells_indices;
+	//row i keeps visibility to every cell j > i, rows below m_traced_rows_count are ready
+	TArray<TBitArray<>> m_rows;
+	int32 m_traced_rows_count;
+	float m_max_distance;
+	FCollisionQueryParams m_trace_params;
+
+};
@@ -26,6 +26,7 @@ protected:
 	void BeginPlay() override;
 	void SetupInputComponent() override;
 	void Tick(float DeltaTime) override;
+	void PlayerTick(float DeltaTime) override;
 
 public:
 
@@ -70,6 +71,8 @@ private:
 	void HandlePlayerUnitKeyboardeAction(vendetta::input_bindings::KEYBOARD_ACTION keyboard_action, float axis = 0.f);
 	void HandlePlayerUnitSelection(FHitResult hit_result, bool enable_follow = false);
 	void HandleActorOnHover();
+	void HandleCursorMovement();
+	const FHitResult& GetCursorHitResult();
 
 	AVEN_GameMode* GetGameMode();
 	AVEN_PlayerUnit* GetActivePlayerUnit();
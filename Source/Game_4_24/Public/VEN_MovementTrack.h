@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class USplineComponent;
+
+//movement spline baked by arc length into evenly spaced samples of location and yaw. spline is solved
+//once when movement starts, then every tick is an index and a lerp between two neighbouring samples
+class GAME_4_24_API FVEN_MovementTrack
+{
+public:
+
+	FVEN_MovementTrack();
+
+	void Reset();
+	void Build(const USplineComponent* spline_component);
+	bool IsBuilt() const;
+
+	float GetLength() const;
+	//distance is clamped to the track
+	FVector GetLocationAtDistance(float distance) const;
+	float GetYawAtDistance(float distance) const;
+	FVector GetEndLocation() const;
+	float GetEndYaw() const;
+
+private:
+
+	int32 GetSampleIndex(float distance, float& alpha) const;
+
+private:
+
+	TArray<FVector> m_locations;
+	TArray<float> m_yaws;
+	float m_length;
+	float m_step;
+
+};
@@ -0,0 +1,45 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NavFilters/NavigationQueryFilter.h"
+
+#include "VEN_NavigationFilter.generated.h"
+
+class ANavigationData;
+
+//unit standing in battle, path queries go around it instead of carving navmesh
+struct FVEN_NavigationBlocker
+{
+	FVector location;
+	float radius;
+	const AActor* owner;
+};
+
+UCLASS()
+class GAME_4_24_API UVEN_NavigationFilter : public UNavigationQueryFilter
+{
+	GENERATED_BODY()
+
+public:
+
+	UVEN_NavigationFilter();
+
+	//reroutes path segments which still cross a blocker (navmesh polygons may be much bigger than units).
+	//false if some blocker cannot be passed, path is left unchanged then
+	static bool AvoidBlockers(const UObject* querier, TArray<FVector>& path_points);
+	static void GatherBlockers(const UObject* querier, TArray<FVEN_NavigationBlocker>& blockers);
+	//length AvoidBlockers would add going round crossed blockers, measured on circles without navigation queries
+	static float EstimateDetourLength(const TArray<FVEN_NavigationBlocker>& blockers, const TArray<FVector>& path_points);
+
+protected:
+
+	void InitializeFilter(const ANavigationData& NavData, const UObject* Querier, FNavigationQueryFilter& Filter) const override;
+
+private:
+
+	static const FVEN_NavigationBlocker* FindCrossedBlocker(const TArray<FVEN_NavigationBlocker>& blockers, const FVector& segment_start, const FVector& segment_end);
+	static bool IsInsideBlocker(const TArray<FVEN_NavigationBlocker>& blockers, const FVector& location);
+
+};
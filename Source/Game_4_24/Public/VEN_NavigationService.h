@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "VEN_NavigationFilter.h"
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "NavigationData.h"
+
+#include "VEN_NavigationService.generated.h"
+
+class AActor;
+class ANavigationData;
+class UNavigationSystemV1;
+class FVEN_ReachabilityField;
+
+struct FVEN_PathQueryResult
+{
+	FVector destination_point = FVector::ZeroVector;
+	bool is_reachable = false;
+	float path_length = 0.f;
+};
+
+DECLARE_DELEGATE_OneParam(FVEN_OnPathBatchCompleted, const TArray<FVEN_PathQueryResult>&);
+
+//path queries straight on navigation data, no spline actors or components are spawned
+UCLASS()
+class GAME_4_24_API UVEN_NavigationService : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	UVEN_NavigationService();
+
+public:
+
+	void Initialize();
+	bool FindPath(const AActor* querier, const FVector& start_point, const FVector& destination_point, TArray<FVector>& path_points) const;
+	bool IsReachable(const AActor* querier, const FVector& destination_point, float* path_length = nullptr) const;
+	//all paths are resolved on navigation worker threads, callback is called on game thread once the whole batch is done
+	uint32 FindPathsAsync(const AActor* querier, const TArray<FVector>& destination_points, const FVEN_OnPathBatchCompleted& callback);
+	void CancelPathsBatch(uint32 batch_id);
+	//dijkstra flood over navmesh polygons from querier location, limited by max cost
+	bool BuildReachabilityField(const AActor* querier, float max_cost, FVEN_ReachabilityField& field) const;
+	FVector GetQueryStartPoint(const AActor* querier) const;
+	static float CalculatePathLength(const TArray<FVector>& path_points);
+
+private:
+
+	UNavigationSystemV1* GetNavigationSystem() const;
+	const ANavigationData* GetNavigationData(const AActor* querier, const FVector& location) const;
+	void OnAsyncPathFound(uint32 query_id, ENavigationQueryResult::Type query_result, FNavPathSharedPtr path, uint32 batch_id, int32 result_index);
+	void CompletePathsBatch(uint32 batch_id);
+
+private:
+
+	struct FPathsBatch
+	{
+		TWeakObjectPtr<const AActor> querier;
+		//taken once with the filter, results are estimated against the same blockers
+		TArray<FVEN_NavigationBlocker> blockers;
+		TArray<FVEN_PathQueryResult> results;
+		int32 pending_queries_count = 0;
+		FVEN_OnPathBatchCompleted callback;
+	};
+
+	TMap<uint32, FPathsBatch> m_paths_batches;
+	uint32 m_last_batch_id;
+
+};
@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+
+#include "VEN_PathPreview.generated.h"
+
+class USplineComponent;
+class USplineMeshComponent;
+class UStaticMesh;
+
+//persistent movement path preview. spline and its mesh segments are reused between paths,
+//segments pool only grows when a longer path is shown and nothing is updated if the path is the same
+UCLASS()
+class GAME_4_24_API AVEN_PathPreview : public AActor
+{
+	GENERATED_BODY()
+
+public:
+
+	AVEN_PathPreview();
+
+public:
+
+	//path points are in world space, segments are not shown if mesh is nullptr
+	void SetPath(const FVector& start_point, const TArray<FVector>& path_points, UStaticMesh* segment_mesh = nullptr);
+	//hides segments, path stays available for queries until it is changed or cleared
+	void Hide();
+	void Clear();
+	bool HasPath() const;
+	USplineComponent* GetSpline() const;
+
+private:
+
+	void UpdateSegments();
+	USplineMeshComponent* CreateSegment();
+
+private:
+
+	UPROPERTY()
+	USplineComponent* m_spline;
+	UPROPERTY()
+	TArray<USplineMeshComponent*> m_segments;
+	UPROPERTY()
+	UStaticMesh* m_segment_mesh;
+
+	FVector m_start_point;
+	TArray<FVector> m_path_points;
+	int32 m_visible_segments_count;
+
+};
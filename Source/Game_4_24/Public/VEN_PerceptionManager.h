@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "Tickable.h"
+
+#include "VEN_PerceptionManager.generated.h"
+
+class AVEN_GameMode;
+class AVEN_EnemyUnit;
+class AVEN_PlayerUnit;
+
+//senses player units for all enemy units. only enemy units found near player units in the units spatial hash
+//are checked and line of sight checks are spread across frames with a fixed budget.
+//line of sight is queried from visibility service, results come with the next frame
+UCLASS()
+class GAME_4_24_API UVEN_PerceptionManager : public UObject, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	UVEN_PerceptionManager();
+
+public:
+
+	void Initialize();
+	void Uninitialize();
+	void RegisterEnemyUnit(AVEN_EnemyUnit* enemy_unit);
+
+	void Tick(float DeltaTime) override;
+	bool IsTickable() const override;
+	TStatId GetStatId() const override;
+
+private:
+
+	struct FPerceptionCheck
+	{
+		AVEN_EnemyUnit* enemy_unit;
+		AVEN_PlayerUnit* player_unit;
+	};
+
+	AVEN_GameMode* GetGameMode() const;
+	void PrepareChecks();
+	bool ProcessCheck(const FPerceptionCheck& check);
+	void OnVisibilityChecked(bool is_visible, TWeakObjectPtr<AVEN_EnemyUnit> enemy_unit_ptr, TWeakObjectPtr<AVEN_PlayerUnit> player_unit_ptr);
+
+private:
+
+	UPROPERTY()
+	TArray<AVEN_EnemyUnit*> m_enemy_units;
+	//neighbourhood of player units is gathered with the biggest radius, then filtered per enemy unit
+	float m_max_sensing_radius;
+
+	TArray<FPerceptionCheck> m_pending_checks;
+	int32 m_next_check_index;
+	bool m_is_initialized;
+
+};
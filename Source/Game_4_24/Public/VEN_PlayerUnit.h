@@ -4,6 +4,9 @@
 
 #include "VEN_InputBindings.h"
 #include "VEN_Types.h"
+#include "VEN_BattleParticipant.h"
+#include "VEN_ReachabilityField.h"
+#include "VEN_MovementTrack.h"
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
@@ -22,10 +25,12 @@ class AVEN_EnemyUnit;
 class UVEN_BattleSystem;
 class UVEN_AnimInstance;
 class UVEN_TactialView;
+class AVEN_PathPreview;
+struct FVEN_BattleUnitRecord;
 
 
 UCLASS()
-class GAME_4_24_API AVEN_PlayerUnit : public ACharacter
+class GAME_4_24_API AVEN_PlayerUnit : public ACharacter, public IVEN_BattleParticipant
 {
 	GENERATED_BODY()
 
@@ -36,6 +41,7 @@ public:
 protected:
 
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	void Tick(float DeltaTime) override;
 
 public:
@@ -59,23 +65,28 @@ public:
 	/* BATTLE */
 
 	bool IsInBattle() const;
-	void OnStartBattle();
-	void OnFinishBattle();
-	void OnStartBattleTurn();
-	void OnFinishBattleTurn();
+	void OnStartBattle() override;
+	void OnFinishBattle() override;
+	void OnStartBattleTurn() override;
+	void OnFinishBattleTurn() override;
 	void OnReceiveDamage(float damage_received, AActor* damage_dealer);
 	vendetta::ATTACK_TYPE GetAttackType() const;
 	int GetHP() const;
 	int GetTotalHP() const;
-	int GetRandomAttackPower() const;
+	int GetRandomAttackPower(FRandomStream& random_stream) const;
 	int GetAttackRange() const;
 	float GetAttackPrice() const;
 	float GetTurnPointsTotal() const;
 	float GetTurnPointsLeft() const;
 	void UpdateTurnPoints(float update_on_value);
-	void ResetTurnPoints();
+	void ResetTurnPoints() override;
 	bool IsDead() const;
+	vendetta::BATTLE_FACTION GetBattleFaction() const override;
+	FVEN_BattleUnitRecord GetBattleUnitRecord() const override;
+	bool ApplyBattleUnitRecord(const FVEN_BattleUnitRecord& record) override;
+	FBattleQueueUnitInfo GetBattleQueueUnitInfo() const override;
 	void ToggleTacticalView();
+	const FVEN_ReachabilityField& GetReachabilityField() const;
 	void OnUpdateFromTacticalView(FVector main_area_center_point, FVector minor_area_center_point, const TArray<FEnemyUnitInfo>& enemy_units_info);
 
 public:
@@ -147,10 +158,16 @@ private:
 	void BuildTemporaryMovementSpline(const FVector& destination_point);
 	void BuildFixedMovementSpline();
 	void DestroyMovementSpline(AActor* movement_spline);
+	void SpawnMovementPathPreview();
+	void HideMovementPathPreview();
+	void DestroyMovementPathPreview();
+	void UpdateHoveredMovementPrice(const FVector& destination_point);
+	void UpdateReachabilityField();
 	void BuildDestinationPointActor(FVector destination_point);
 	void DestroyDestinationPointActor();
 	void SetupDestinationPointActor(FVector destination_point);
 	float CalculateTimeToCompleteMovementSpline(USplineComponent* spline_component);
+	float CalculateTimeToCompleteMovement(float movement_length);
 	void PrepareMovement(FHitResult hit_result);
 	void StartMovement();
 	void ContinueMovement();
@@ -185,6 +202,8 @@ private:
 	bool IsEnoughPointsForAction(vendetta::IN_BATTLE_UNIT_ACTION action);
 	vendetta::DIRECTION GetAttackDirection(FRotator attacker_rotation) const;
 	void RecoverHPs();
+	//unit ticks only while moving or recovering
+	void UpdateTickEnabled();
 	bool CanInitiateBattleInPlace(AVEN_EnemyUnit* enemy_unit);
 	bool CanInitiateBattleAfterMove(AVEN_EnemyUnit* enemy_unit);
 	bool CanAttackInPlace(AVEN_EnemyUnit* enemy_unit, bool consider_turn_points = true);
@@ -199,13 +218,15 @@ private:
 	UPROPERTY()
 	UVEN_AnimInstance* m_anim_instance;
 	UPROPERTY()
-	AActor* m_movement_spline_actor_temporary;
+	AVEN_PathPreview* m_movement_path_preview;
 	UPROPERTY()
 	USplineComponent* m_movement_spline_component_temporary;
 	UPROPERTY()
 	AActor* m_movement_spline_actor_fixed;
 	UPROPERTY()
 	USplineComponent* m_movement_spline_component_fixed;
+	//fixed spline baked when movement starts, ticks read it instead of the spline
+	FVEN_MovementTrack m_movement_track;
 	UPROPERTY()
 	UStaticMesh* m_movement_spline_mesh_enabled;
 	UPROPERTY()
@@ -229,6 +250,11 @@ private:
 	bool m_move_and_interact_mode;
 	bool m_move_and_interact_spline_calculated;
 
+	//in battle hovered movement price comes from reachability field built at turn start
+	FVEN_ReachabilityField m_reachability_field;
+	float m_hovered_movement_price;
+	bool m_hovered_movement_price_is_used;
+
 	/* BATTLE */
 
 	UPROPERTY()
@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "VEN_Types.h"
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+
+#include "VEN_RangeOverlay.generated.h"
+
+class UDecalComponent;
+class UMaterialInterface;
+
+struct FVEN_RangeCircle
+{
+	FVector2D center;
+	float radius;
+	vendetta::RANGE_CIRCLE_TYPE type;
+
+	bool operator==(const FVEN_RangeCircle& other) const
+	{
+		return center == other.center && radius == other.radius && type == other.type;
+	}
+};
+
+//draws range circles of the tactical view with pooled decals, one per circle with the tactical view
+//materials. decals are created once and reused, nothing is respawned when a unit dies and nothing is
+//touched while circles stay the same. a single pass overlay needs its own decal material, it is not in content
+UCLASS()
+class GAME_4_24_API AVEN_RangeOverlay : public AActor
+{
+	GENERATED_BODY()
+
+public:
+
+	AVEN_RangeOverlay();
+
+public:
+
+	//circles are in world space, ground_z is the height decals are projected at
+	void SetCircles(const TArray<FVEN_RangeCircle>& circles, float ground_z);
+	void Hide();
+
+private:
+
+	UMaterialInterface* GetCircleMaterial(vendetta::RANGE_CIRCLE_TYPE type) const;
+	void UpdateDecals();
+
+private:
+
+	UPROPERTY()
+	UMaterialInterface* m_material_bow;
+	UPROPERTY()
+	UMaterialInterface* m_material_sword;
+	UPROPERTY()
+	UMaterialInterface* m_material_minor;
+	UPROPERTY()
+	TArray<UDecalComponent*> m_decals;
+
+	TArray<FVEN_RangeCircle> m_circles;
+	float m_ground_z;
+	bool m_is_visible;
+
+};
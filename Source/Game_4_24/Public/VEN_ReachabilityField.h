@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "VEN_NavigationFilter.h"
+
+#include "CoreMinimal.h"
+
+//move costs from one origin to every navmesh polygon within a cost budget, rasterized into a grid.
+//every node keeps the point it was entered through, so cost of any location is its node cost plus
+//straight distance from that point (and detours around blockers); cost lookup reads one cell.
+//cells keep a layer per navmesh level they are covered by, lookup takes the one nearest in height
+class GAME_4_24_API FVEN_ReachabilityField
+{
+public:
+
+	FVEN_ReachabilityField();
+
+	void Reset();
+	void Setup(const FVector& origin, float max_cost, float cell_size, const TArray<FVEN_NavigationBlocker>& blockers);
+	bool IsValid() const;
+	//false if location is not reachable within cost budget
+	bool GetMoveCost(const FVector& location, float& cost) const;
+	float GetMaxCost() const;
+
+	//building, used by navigation service
+	int32 AddNode(const FVector& entry_point, float cost);
+	void UpdateNode(int32 node_index, const FVector& entry_point, float cost);
+	const FVector& GetNodeEntryPoint(int32 node_index) const;
+	float GetNodeCost(int32 node_index) const;
+	//straight move cost between two points, detours around blockers are added
+	float GetSegmentCost(const FVector& start, const FVector& end) const;
+	//cells touched by convex polygon are assigned to node unless a cheaper node of the same level already owns them
+	void RasterizeNode(int32 node_index, const TArray<FVector>& polygon_verts);
+
+private:
+
+	bool GetCellCoords(const FVector& location, int32& x, int32& y) const;
+	void RasterizeCell(int32 cell_index, int32 node_index, float min_z, float max_z);
+
+private:
+
+	struct FNode
+	{
+		FVector entry_point;
+		float cost;
+	};
+
+	//cell layers are linked in a list starting from the cell
+	struct FCellLayer
+	{
+		int32 node_index;
+		float min_z;
+		float max_z;
+		int32 next_layer_index;
+	};
+
+	TArray<FNode> m_nodes;
+	TArray<int32> m_cells;
+	TArray<FCellLayer> m_layers;
+	TArray<FVEN_NavigationBlocker> m_blockers;
+	FVector m_grid_origin;
+	float m_max_cost;
+	float m_cell_size;
+	int32 m_grid_size;
+
+};
@@ -0,0 +1,55 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "VEN_Types.h"
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "Tickable.h"
+
+#include "VEN_SignificanceManager.generated.h"
+
+class AVEN_GameMode;
+
+//scores enemy units, npcs and interactable items a few times per second by distance to camera focus and party
+//and by battle involvement, then scales their tick interval and particles by bucket.
+//actors are touched only when their bucket changes. ven.ShowSignificance draws buckets over actors
+UCLASS()
+class GAME_4_24_API UVEN_SignificanceManager : public UObject, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	UVEN_SignificanceManager();
+
+public:
+
+	void Initialize();
+	void Uninitialize();
+	void RegisterActor(AActor* actor);
+	vendetta::SIGNIFICANCE GetSignificance(const AActor* actor) const;
+
+	void Tick(float DeltaTime) override;
+	bool IsTickable() const override;
+	TStatId GetStatId() const override;
+
+private:
+
+	AVEN_GameMode* GetGameMode() const;
+	void UpdateSignificance();
+	vendetta::SIGNIFICANCE CalculateSignificance(const AActor* actor, const TArray<FVector>& focus_locations) const;
+	void ApplySignificance(AActor* actor, vendetta::SIGNIFICANCE significance);
+
+private:
+
+	UPROPERTY()
+	TArray<AActor*> m_actors;
+	//parallel to m_actors
+	TArray<vendetta::SIGNIFICANCE> m_significances;
+
+	float m_time_to_update;
+	bool m_is_initialized;
+
+};
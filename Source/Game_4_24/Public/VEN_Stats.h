@@ -0,0 +1,8 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Stats/Stats.h"
+
+//use "stat Vendetta" in console to show game specific counters
+DECLARE_STATS_GROUP(TEXT("Vendetta"), STATGROUP_Vendetta, STATCAT_Advanced);
@@ -10,9 +10,12 @@
 #include "VEN_TactialView.generated.h"
 
 class AVEN_PlayerUnit;
+class AVEN_EnemyUnit;
 class UVEN_BattleSystem;
+class UVEN_BattleInstance;
 class USplineComponent;
-class UMaterialInstance;
+class AVEN_PathPreview;
+class AVEN_RangeOverlay;
 
 UCLASS()
 class GAME_4_24_API UVEN_TactialView : public UObject
@@ -30,8 +33,12 @@ public:
 
 private:
 
+	UVEN_BattleInstance* GetBattle() const;
+	bool IsEnemyUnitsInfoValid() const;
+	void InvalidateEnemyUnitsInfo();
 	void GatherEnemyUnitsRelatedInfo();
-	void UpdateDecals();
+	bool UpdateHoverRelatedInfo(bool force_update);
+	void UpdateRangeOverlay();
 	void NotifyOwner();
 	bool IsHoveredUnit();
 	bool CanActorBeAttackedFromPoint(AActor* actor, FVector point) const;
@@ -50,24 +57,27 @@ private:
 	UPROPERTY()
 	UVEN_BattleSystem* m_battle_system;
 	UPROPERTY()
-	AActor* m_movement_spline_actor;
+	AVEN_PathPreview* m_movement_path;
 	UPROPERTY()
 	USplineComponent* m_movement_spline_component;
 
 	UPROPERTY()
-	AActor* m_main_area_decal_actor;
-	UPROPERTY()
-	TArray<AActor*> m_minor_area_decal_actors;
-	UPROPERTY()
-	UMaterialInstance* m_main_area_decal_material_bow;
-	UPROPERTY()
-	UMaterialInstance* m_main_area_decal_material_sword;
-	UPROPERTY()
-	UMaterialInstance* m_main_area_decal_material_minor;
+	AVEN_RangeOverlay* m_range_overlay;
 
 	bool m_is_allowed;
 	bool m_movement_spline_is_built;
 
 	FVector m_hovered_location;
 	TArray<FEnemyUnitInfo> m_enemy_units_info;
+
+	//turn stable part of enemy units info (path prices, main area visibility) is kept
+	//until battle state revision or owner location changes
+	TArray<TWeakObjectPtr<AVEN_EnemyUnit>> m_enemy_units;
+	bool m_enemy_units_info_is_valid;
+	uint32 m_enemy_units_info_revision;
+	FVector m_enemy_units_info_owner_location;
+
+	//minor area visibility is recalculated only when hovered cell changes
+	FIntVector m_hovered_cell;
+	bool m_hovered_cell_is_valid;
 };
@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+//circular turn order over integer participant handles. participants are linked into a ring
+//(next/previous per handle), so advancing a turn, removing a participant and looking up
+//who follows whom are O(1). storage grows only while participants are added before battle start
+class GAME_4_24_API FVEN_TurnQueue
+{
+public:
+
+	//read only walk over the ring starting from the current turn owner
+	class FConstIterator
+	{
+	public:
+
+		FConstIterator(const FVEN_TurnQueue& queue, int32 handle, int32 remaining)
+			: m_queue(queue)
+			, m_handle(handle)
+			, m_remaining(remaining)
+		{
+
+		}
+
+		int32 operator*() const { return m_handle; }
+		FConstIterator& operator++() { m_handle = m_queue.GetNext(m_handle); m_remaining--; return *this; }
+		bool operator!=(const FConstIterator& other) const { return m_remaining != other.m_remaining; }
+
+	private:
+
+		const FVEN_TurnQueue& m_queue;
+		int32 m_handle;
+		int32 m_remaining;
+	};
+
+	FVEN_TurnQueue();
+
+	void Reset(int32 capacity = 0);
+	//participant is placed right before current turn owner (end of the turn order)
+	void Add(int32 handle);
+	void Remove(int32 handle);
+	void Advance();
+	bool Contains(int32 handle) const;
+	int32 GetHead() const;
+	int32 GetNext(int32 handle) const;
+	int32 Num() const;
+
+	FConstIterator begin() const { return FConstIterator(*this, m_head, m_count); }
+	FConstIterator end() const { return FConstIterator(*this, INDEX_NONE, 0); }
+
+private:
+
+	TArray<int32> m_next;
+	TArray<int32> m_previous;
+	TBitArray<> m_contains;
+	int32 m_head;
+	int32 m_count;
+
+};
@@ -80,6 +80,33 @@ namespace vendetta
 		MOVE_AND_ATTACK
 	};
 
+	enum class BATTLE_FACTION
+	{
+		PLAYER,
+		ENEMY
+	};
+
+	//values are written into battle replay files, append only
+	enum class BATTLE_REPLAY_EVENT : uint8
+	{
+		START = 0,
+		MOVE = 1,
+		ATTACK = 2,
+		TURN_END = 3,
+		DEATH = 4,
+		FINISH = 5
+	};
+
+	//significance manager buckets, from updated every frame to updated rarely
+	enum class SIGNIFICANCE
+	{
+		CRITICAL,
+		HIGH,
+		MEDIUM,
+		LOW,
+		COUNT
+	};
+
 	//animations
 	enum class ANIMATION_ACTION
 	{
@@ -127,6 +154,24 @@ namespace vendetta
 		COLLECT
 	};
 
+	enum class CURSOR_TARGET
+	{
+		NONE,
+		OTHER,
+		PLAYER_UNIT,
+		ENEMY_UNIT,
+		INTERACTABLE_ITEM,
+		INTERACTABLE_NPC
+	};
+
+	//picks the tactical view decal material of a range circle
+	enum class RANGE_CIRCLE_TYPE
+	{
+		OWNER_MELEE = 0,
+		OWNER_RANGE = 1,
+		ENEMY = 2
+	};
+
 	enum class CAMERA_PP_MATERIAL_TYPE
 	{
 		DEFAULT,
@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+
+#include "VEN_UnitsSpatialHash.generated.h"
+
+class AActor;
+
+//uniform grid of all units (player, enemy, npc) for "units near location" queries without physics overlaps.
+//units register once and report their moves, a unit changes its cell only when it crosses cell border.
+//cells are not seen by gc, so units unregister in EndPlay before they are destroyed
+UCLASS()
+class GAME_4_24_API UVEN_UnitsSpatialHash : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	UVEN_UnitsSpatialHash();
+
+public:
+
+	void Initialize();
+	void Uninitialize();
+	void RegisterUnit(AActor* unit);
+	void UnregisterUnit(AActor* unit);
+	void UpdateUnitLocation(AActor* unit);
+	//units whose location is inside the sphere, filtered by class if it is set
+	void GatherUnits(const FVector& center, float radius, TArray<AActor*>& units, const UClass* unit_class = nullptr, const AActor* unit_to_ignore = nullptr) const;
+
+private:
+
+	FIntPoint GetCell(const FVector& location) const;
+	void RemoveFromCell(AActor* unit, const FIntPoint& cell);
+
+private:
+
+	UPROPERTY()
+	TArray<AActor*> m_units;
+	TMap<AActor*, FIntPoint> m_units_cells;
+	TMap<FIntPoint, TArray<AActor*>> m_cells;
+
+};
@@ -0,0 +1,83 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "Engine/World.h"
+
+#include "VEN_VisibilityService.generated.h"
+
+class AActor;
+class UVEN_LineOfSightGrid;
+
+DECLARE_DELEGATE_OneParam(FVEN_OnVisibilityChecked, bool);
+
+//line of sight checks shared by sensing and battle ui. traces are queued as async traces (results come next frame)
+//and cached per observer, target and their position buckets, so repeated checks are free
+UCLASS()
+class GAME_4_24_API UVEN_VisibilityService : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	UVEN_VisibilityService();
+
+public:
+
+	void Initialize();
+	void Uninitialize();
+	//callback is called immediately for fresh cached result, otherwise next frame
+	void QueryVisibility(const AActor* observer, const AActor* target, const FVector& observer_point, const FVEN_OnVisibilityChecked& callback);
+	//for decisions which cannot wait: cached result (refreshed asynchronously if outdated) or synchronous trace on cache miss
+	bool IsVisible(const AActor* observer, const AActor* target, const FVector& observer_point);
+
+private:
+
+	struct FVisibilityKey
+	{
+		const AActor* observer;
+		const AActor* target;
+		FIntVector observer_bucket;
+		FIntVector target_bucket;
+
+		bool operator==(const FVisibilityKey& other) const
+		{
+			return observer == other.observer && target == other.target && observer_bucket == other.observer_bucket && target_bucket == other.target_bucket;
+		}
+
+		friend uint32 GetTypeHash(const FVisibilityKey& key)
+		{
+			uint32 hash = HashCombine(GetTypeHash(key.observer), GetTypeHash(key.target));
+			hash = HashCombine(hash, GetTypeHash(key.observer_bucket));
+			return HashCombine(hash, GetTypeHash(key.target_bucket));
+		}
+	};
+
+	struct FVisibilityEntry
+	{
+		bool is_visible = false;
+		bool has_result = false;
+		uint64 frame = 0;
+		uint32 pending_trace_id = 0;
+		TArray<FVEN_OnVisibilityChecked> callbacks;
+	};
+
+	//grid of the observer's battle rejects blocked sight without traces, clear sight is still traced
+	const UVEN_LineOfSightGrid* GetLineOfSightGrid(const AActor* observer) const;
+	FVisibilityKey MakeKey(const AActor* observer, const AActor* target, const FVector& observer_point) const;
+	bool IsFresh(const FVisibilityEntry& entry) const;
+	void StartAsyncTrace(const FVisibilityKey& key, FVisibilityEntry& entry, const FVector& observer_point);
+	void OnAsyncTraceCompleted(const FTraceHandle& trace_handle, FTraceDatum& trace_datum);
+	bool IsTraceClear(const AActor* target, const FHitResult* blocking_hit) const;
+	void RemoveOutdatedEntries();
+
+private:
+
+	TMap<FVisibilityKey, FVisibilityEntry> m_entries;
+	TMap<uint32, FVisibilityKey> m_pending_traces;
+	uint32 m_last_trace_id;
+	FTraceDelegate m_trace_delegate;
+
+};